@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <vector>
+#include <string>
+
+#include "unicode/string_view.hpp"
+#include "text.hpp"
+
+/// Number of allocations with global operator new
+static size_t allocations = 0;
+
+// Replacements are not inlined, so that GCC doesn't pair malloc and free
+// with library operators and warn about mismatch
+
+[[gnu::noinline]]
+void *operator new(std::size_t size)
+{
+	++allocations;
+	if (auto p = std::malloc(size)) { return p; }
+	throw std::bad_alloc();
+}
+
+[[gnu::noinline]]
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+	++allocations;
+	auto align = std::max(sizeof(void *), size_t(alignment));
+	if (auto p = std::aligned_alloc(align, (size + align - 1) / align * align))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+[[gnu::noinline]]
+void operator delete(void *p) noexcept { std::free(p); }
+
+[[gnu::noinline]]
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+
+[[gnu::noinline]]
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+[[gnu::noinline]]
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept 
+{ 
+	std::free(p); 
+}
+
+/// Get lines of all corpora
+static const std::vector<std::string_view> &getLines()
+{
+	static const std::string text = []
+	{
+		std::string text;
+		for (
+			auto language : {
+				"english", "german", "russian", "french", 
+				"chinese", "japanese", "korean"
+			}
+		)
+		{
+			text += readFile(std::string("./data/") + language + "/wiki.txt");
+		}
+		return text;
+	}();
+	static const std::vector<std::string_view> lines = []
+	{
+		std::vector<std::string_view> lines;
+		std::string_view rest = text;
+		while (!rest.empty())
+		{
+			auto end = std::min(rest.find('\n'), rest.size() - 1) + 1;
+			lines.push_back(rest.substr(0, end));
+			rest.remove_prefix(end);
+		}
+		return lines;
+	}();
+	return lines;
+}
+
+/// Build views over lines with default allocator
+static void viewsDefault(benchmark::State& state)
+{
+	auto &lines = getLines();
+	auto before = allocations;
+	for (auto _ : state)
+	{
+		for (auto line : lines)
+		{
+			unicode::string_view view = line;
+			benchmark::DoNotOptimize(view);
+		}
+	}
+	auto views = state.iterations() * lines.size();
+	state.counters["allocations_per_view"] = 
+		double(allocations - before) / views;
+	state.SetItemsProcessed(views);
+}
+BENCHMARK(viewsDefault);
+
+/// Build views over lines in arena, that is released once per batch
+static void viewsArena(benchmark::State& state)
+{
+	auto &lines = getLines();
+	std::pmr::monotonic_buffer_resource arena(1 << 20);
+	auto before = allocations;
+	for (auto _ : state)
+	{
+		for (auto line : lines)
+		{
+			unicode::string_view view(line, &arena);
+			benchmark::DoNotOptimize(view);
+		}
+		arena.release();
+	}
+	auto views = state.iterations() * lines.size();
+	state.counters["allocations_per_view"] = 
+		double(allocations - before) / views;
+	state.SetItemsProcessed(views);
+}
+BENCHMARK(viewsArena);
+
+
+BENCHMARK_MAIN();
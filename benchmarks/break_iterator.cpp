@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include <unicode/brkiter.h>
+
+#include "unicode/segment_view.hpp"
+
+#include "../sources/icu.hpp"
+
+/// Short strings, e.g. labels and names
+static const std::vector<std::string> &getLabels()
+{
+	static const std::vector<std::string> labels = {
+		"Hello, world!", "Привет, мир!", "你好，世界！", "Save as...", 
+		"user_12345", "Grüße", "éclair", "👍🏽 Like", "Mr. Smith", "OK"
+	};
+	return labels;
+}
+
+/// Iterate over characters of label
+static size_t countBoundaries(icu::BreakIterator &it)
+{
+	size_t count = 0;
+	while (it.next() != icu::BreakIterator::DONE) { ++count; }
+	return count;
+}
+
+/// Open text and create new iterator for each label
+static void breakIteratorCreate(benchmark::State& state)
+{
+	auto &labels = getLabels();
+	for (auto _ : state)
+	{
+		for (auto &label : labels)
+		{
+			auto utext = openUText(label);
+			UErrorCode errorCode = U_ZERO_ERROR;
+			std::unique_ptr<icu::BreakIterator> it{
+				icu::BreakIterator::createCharacterInstance(
+					icu::Locale::getDefault(), errorCode
+				)
+			};
+			it->setText(utext.get(), errorCode);
+			benchmark::DoNotOptimize(countBoundaries(*it));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * labels.size());
+}
+BENCHMARK(breakIteratorCreate);
+
+/// Open text and copy cached prototype of iterator for each label
+static void breakIteratorCopy(benchmark::State& state)
+{
+	auto &labels = getLabels();
+	for (auto _ : state)
+	{
+		for (auto &label : labels)
+		{
+			auto utext = openUText(label);
+			auto it = getCharacterBreakIterator(utext.get());
+			benchmark::DoNotOptimize(countBoundaries(*it));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * labels.size());
+}
+BENCHMARK(breakIteratorCopy);
+
+/// Reopen text in place and move cached iterator to it for each label
+static void breakIteratorCached(benchmark::State& state)
+{
+	auto &labels = getLabels();
+	LocalUText local;
+	for (auto _ : state)
+	{
+		for (auto &label : labels)
+		{
+			auto it = getCachedBreakIterator(
+				local.open(label), 
+				icu::BreakIterator::createCharacterInstance
+			);
+			benchmark::DoNotOptimize(countBoundaries(*it));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * labels.size());
+}
+BENCHMARK(breakIteratorCached);
+
+/// Build view over words of each label
+static void wordViewShort(benchmark::State& state)
+{
+	auto &labels = getLabels();
+	for (auto _ : state)
+	{
+		for (auto &label : labels)
+		{
+			unicode::word_view words = label;
+			benchmark::DoNotOptimize(words.size());
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * labels.size());
+}
+BENCHMARK(wordViewShort);
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <string>
+
+#include "unicode/layout_builder.hpp"
+#include "text.hpp"
+
+/// Number of rows
+constexpr size_t count = 1000000;
+/// Maximal size of row in bytes
+constexpr size_t max_row_size = 80;
+
+/// Get rows: lines of all corpora, cut to max_row_size and repeated
+static const std::vector<std::string_view> &getRows()
+{
+	static const std::string text = []
+	{
+		std::string text;
+		for (
+			auto language : {
+				"english", "german", "russian", "french", 
+				"chinese", "japanese", "korean"
+			}
+		)
+		{
+			text += readFile(std::string("./data/") + language + "/wiki.txt");
+		}
+		return text;
+	}();
+	static const std::vector<std::string_view> rows = []
+	{
+		std::vector<std::string_view> rows;
+		for (size_t start = 0; start < text.size();)
+		{
+			auto end = std::min(
+				{text.find('\n', start), start + max_row_size, text.size()}
+			);
+			while (end < text.size() && (uint8_t(text[end]) & 0xC0) == 0x80) 
+			{ 
+				--end; 
+			}
+			if (end != start) 
+			{ 
+				rows.push_back(std::string_view(text).substr(start, end - start)); 
+			}
+			start = end + (end < text.size() && text[end] == '\n');
+		}
+		rows.reserve(count);
+		for (size_t i = 0; rows.size() < count; ++i) { rows.push_back(rows[i]); }
+		rows.resize(count);
+		return rows;
+	}();
+	return rows;
+}
+
+/// Build layout of each row separately
+static void rowsLayoutOf(benchmark::State& state)
+{
+	auto &rows = getRows();
+	for (auto _ : state)
+	{
+		std::vector<unicode::layout> layouts;
+		layouts.reserve(rows.size());
+		for (auto row : rows) { layouts.push_back(unicode::layout::of(row)); }
+		benchmark::DoNotOptimize(layouts.data());
+	}
+	state.SetItemsProcessed(state.iterations() * rows.size());
+}
+BENCHMARK(rowsLayoutOf)->Unit(benchmark::kMillisecond);
+
+/// Build layouts of rows in batch on specified number of threads
+static void rowsBuilder(benchmark::State& state)
+{
+	auto &rows = getRows();
+	unicode::layout_builder builder(state.range(0));
+	for (auto _ : state)
+	{
+		auto layouts = builder.build(rows);
+		benchmark::DoNotOptimize(layouts.data());
+		layouts.clear();
+		builder.reset();
+	}
+	state.SetItemsProcessed(state.iterations() * rows.size());
+}
+BENCHMARK(rowsBuilder)
+	->Arg(1)
+	->Arg(std::max(2u, std::thread::hardware_concurrency()))
+	->Unit(benchmark::kMillisecond);
+
+
+BENCHMARK_MAIN();
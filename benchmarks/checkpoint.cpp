@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+
+#include <cassert>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "unicode/string_view.hpp"
+#include "unicode/checkpoint_layout.hpp"
+
+using namespace unicode;
+
+/// Languages of corpora
+static const char *languages[] = {
+	"english", "russian", "chinese", "german", "japanese", "french", "korean"
+};
+
+/// Read corpus of language
+static const std::string &getCorpus(size_t language)
+{
+	static std::vector<std::string> corpora(std::size(languages));
+	auto &corpus = corpora[language];
+	if (!corpus.empty()) { return corpus; }
+
+	std::ifstream file(std::string("./data/") + languages[language] + "/wiki.txt");
+	assert(file && "Can't open file");
+	corpus.assign(
+		(std::istreambuf_iterator<char>(file)), 
+		(std::istreambuf_iterator<char>())
+	);
+	return corpus;
+}
+
+/// Get characters at random indexes of view
+template<typename View>
+static void accessRandomly(benchmark::State& state, const View &view)
+{
+	std::mt19937_64 random(42);
+	std::vector<size_t> indexes(1 << 16);
+	for (auto &index : indexes) { index = random() % view.size(); }
+
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		auto c = view[indexes[i++ % indexes.size()]];
+		benchmark::DoNotOptimize(c);
+	}
+	state.SetLabel(languages[state.range(0)]);
+	state.counters["layout_bytes_per_character"] = 
+		double(view.memory_usage()) / view.size();
+}
+
+/// Random access with full layout, as a baseline
+static void fullLayoutRandomAccess(benchmark::State& state)
+{
+	string_view view = getCorpus(state.range(0));
+	accessRandomly(state, view);
+}
+BENCHMARK(fullLayoutRandomAccess)->DenseRange(0, std::size(languages) - 1);
+
+/// Random access with checkpoint every K characters
+static void checkpointRandomAccess(benchmark::State& state)
+{
+	auto &corpus = getCorpus(state.range(0));
+	basic_string_view<checkpoint_layout> view(
+		corpus, checkpoint_layout::of(corpus, state.range(1))
+	);
+	accessRandomly(state, view);
+}
+BENCHMARK(checkpointRandomAccess)
+	->ArgsProduct({
+		benchmark::CreateDenseRange(0, std::size(languages) - 1, 1),
+		benchmark::CreateRange(16, 4096, 4)
+	});
+
+/// Iterate over characters with checkpoint every K characters
+static void checkpointIteration(benchmark::State& state)
+{
+	auto &corpus = getCorpus(state.range(0));
+	basic_string_view<checkpoint_layout> view(
+		corpus, checkpoint_layout::of(corpus, state.range(1))
+	);
+	for (auto _ : state)
+	{
+		for (auto c : view)
+		{
+			benchmark::DoNotOptimize(c);
+		}
+	}
+	state.SetLabel(languages[state.range(0)]);
+	state.SetItemsProcessed(state.iterations() * view.size());
+}
+BENCHMARK(checkpointIteration)
+	->ArgsProduct({
+		benchmark::CreateDenseRange(0, std::size(languages) - 1, 1),
+		{16, 4096}
+	});
+
+
+BENCHMARK_MAIN();
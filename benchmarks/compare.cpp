@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include <unicode/coll.h>
+
+#include "unicode/utf8/compare.hpp"
+#include "unicode/utf8/comparator.hpp"
+#include "text.hpp"
+
+/// Split text into whitespace separated words
+static std::vector<std::string> splitWords(const std::string &text)
+{
+	std::vector<std::string> words;
+	std::istringstream stream(text);
+	for (std::string word; stream >> word;) { words.push_back(word); }
+	return words;
+}
+
+using namespace unicode;
+
+/// Compare with new collator for each comparison, as it was done before
+static std::strong_ordering compareUncached(
+	std::string_view lhs, 
+	std::string_view rhs
+)
+{
+	UErrorCode errorCode = U_ZERO_ERROR;
+	std::unique_ptr<icu::Collator> coll{
+		icu::Collator::createInstance(icu::Locale::getDefault(), errorCode)
+	};
+	errorCode = U_ZERO_ERROR;
+	return coll->compareUTF8(lhs, rhs, errorCode) <=> 0;
+}
+
+#define BENCHMARK_COMPARE(name, compare) \
+	static void name(benchmark::State& state, const char *language) \
+	{ \
+		auto words = splitWords( \
+			readFile(std::string("./data/") + language + "/wiki.txt") \
+		); \
+		size_t i = 0; \
+		for (auto _ : state) \
+		{ \
+			auto &lhs = words[i % words.size()]; \
+			auto &rhs = words[(i + 1) % words.size()]; \
+			benchmark::DoNotOptimize(compare(lhs, rhs)); \
+			++i; \
+		} \
+		state.SetItemsProcessed(state.iterations()); \
+	} \
+	BENCHMARK_CAPTURE(name, english, "english"); \
+	BENCHMARK_CAPTURE(name, russian, "russian"); \
+	BENCHMARK_CAPTURE(name, chinese, "chinese");
+
+static const utf8::comparator comparator;
+
+BENCHMARK_COMPARE(uncachedCollator, compareUncached)
+BENCHMARK_COMPARE(cachedCollator, utf8::compare)
+BENCHMARK_COMPARE(reusableComparator, comparator.compare)
+
+
+BENCHMARK_MAIN();
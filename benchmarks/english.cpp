@@ -1,5 +1,8 @@
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
+#include <iterator>
+#include <numeric>
 #include <string>
 #include <fstream>
 #include <memory>
@@ -94,5 +97,18 @@ static void englishWithUnicodeStringView(benchmark::State& state)
 }
 BENCHMARK(englishWithUnicodeStringView);
 
+/// Construction of layout for english string
+static void englishLayout(benchmark::State& state) 
+{
+	auto &ascii = getASCII();
+	for (auto _ : state)
+	{
+		auto layout = unicode::layout::of(ascii);
+		benchmark::DoNotOptimize(layout);
+	}
+	state.SetBytesProcessed(state.iterations() * ascii.size());
+}
+BENCHMARK(englishLayout);
+
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "unicode/string_view.hpp"
+
+using namespace unicode;
+
+/// Size of synthetic texts in bytes
+constexpr size_t text_size = 1 << 20;
+
+/// Repeat pattern up to the size of synthetic text
+static std::string repeat(std::string_view pattern)
+{
+	std::string text;
+	text.reserve(text_size + pattern.size());
+	while (text.size() < text_size) { text += pattern; }
+	return text;
+}
+
+/// Get synthetic text with worst-case layout
+static const std::string &getText(size_t kind)
+{
+	static const std::vector<std::string> texts = {
+		// ASCII and Cyrillic, one character each
+		repeat("aб"),
+		// Emoji sequences, flags and modifiers of different sizes
+		repeat("👨‍👩‍👧👍🏽🇺🇸😀👩‍💻🏳️‍🌈"),
+		// Combining marks and scripts of different sizes
+		repeat("éaб你😀ä́б́"),
+	};
+	return texts[kind];
+}
+
+/// Names of synthetic texts
+static const char *textNames[] = {"alternating", "emoji", "combining"};
+
+/// Build layout of synthetic text
+static void fragmentedLayout(benchmark::State& state)
+{
+	auto &text = getText(state.range(0));
+	for (auto _ : state)
+	{
+		auto layout = layout::of(text);
+		benchmark::DoNotOptimize(layout);
+	}
+	state.SetLabel(textNames[state.range(0)]);
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(fragmentedLayout)->DenseRange(0, 2);
+
+/// Get character at random index of synthetic text
+static void fragmentedRandomAccess(benchmark::State& state)
+{
+	string_view view = getText(state.range(0));
+
+	std::mt19937_64 random(42);
+	std::vector<size_t> indexes(1 << 16);
+	for (auto &index : indexes) { index = random() % view.size(); }
+
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		auto c = view[indexes[i++ % indexes.size()]];
+		benchmark::DoNotOptimize(c);
+	}
+	state.SetLabel(textNames[state.range(0)]);
+	state.counters["layout_bytes_per_character"] = 
+		double(view.memory_usage()) / view.size();
+}
+BENCHMARK(fragmentedRandomAccess)->DenseRange(0, 2);
+
+/// Iterate over characters of synthetic text
+static void fragmentedIteration(benchmark::State& state)
+{
+	string_view view = getText(state.range(0));
+	for (auto _ : state)
+	{
+		for (auto c : view)
+		{
+			benchmark::DoNotOptimize(c);
+		}
+	}
+	state.SetLabel(textNames[state.range(0)]);
+	state.SetItemsProcessed(state.iterations() * view.size());
+}
+BENCHMARK(fragmentedIteration)->DenseRange(0, 2);
+
+
+BENCHMARK_MAIN();
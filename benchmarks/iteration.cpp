@@ -11,6 +11,7 @@
 #include "unicode/string_view.hpp"
 
 #include "../sources/icu.hpp"
+#include "../sources/grapheme.hpp"
 
 /// Read whole file content
 static std::string readFile(const std::string &path)
@@ -61,9 +62,32 @@ using namespace unicode;
 	} \
 	BENCHMARK(name ## BreakIterator);
 
+#define BENCHMARK_SEGMENTER_LANGUAGE(name) \
+	static void name ## Segmenter(benchmark::State& state) \
+	{ \
+		auto content = readFile("./data/" #name "/wiki.txt"); \
+		for (auto _ : state) \
+		{ \
+			grapheme::segmenter segmenter(content); \
+			for ( \
+				size_t start = 0, end = segmenter.next(); \
+				end != segmenter.npos; \
+				start = end, end = segmenter.next() \
+			) \
+			{ \
+				auto c = \
+					std::string_view(content.data() + start, end - start); \
+				benchmark::DoNotOptimize(c); \
+			} \
+		} \
+		state.SetBytesProcessed(state.iterations() * content.size()); \
+	} \
+	BENCHMARK(name ## Segmenter);
+
 #define BENCHMARK_LANGUAGE(name) \
 	BENCHMARK_STRING_ITERATOR_LANGUAGE(name) \
-	BENCHMARK_BREAK_ITERATOR_LANGUAGE(name)
+	BENCHMARK_BREAK_ITERATOR_LANGUAGE(name) \
+	BENCHMARK_SEGMENTER_LANGUAGE(name)
 
 
 /* 1-st type of texts */
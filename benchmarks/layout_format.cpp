@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <cassert>
+#include <string>
+
+#include "unicode/layout.hpp"
+#include "text.hpp"
+
+/// Size of benchmark text in bytes
+static const size_t textSize = getTextSize(size_t(1) << 26);
+
+/// Start without index: segment text
+static void startupWithoutIndex(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	for (auto _ : state)
+	{
+		auto layout = unicode::layout::of(text);
+		benchmark::DoNotOptimize(layout);
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(startupWithoutIndex)->Unit(benchmark::kMillisecond);
+
+/// Start with index: load serialized layout, verifying checksums
+static void startupWithIndex(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	auto data = unicode::layout::of(text).serialize(text);
+	for (auto _ : state)
+	{
+		auto layout = unicode::layout::deserialize(data, text);
+		assert(layout && "layout is not loaded");
+		benchmark::DoNotOptimize(layout);
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+	state.counters["index_bytes"] = data.size();
+}
+BENCHMARK(startupWithIndex)->Unit(benchmark::kMillisecond);
+
+/// Serialize layout
+static void serializeLayout(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	auto layout = unicode::layout::of(text);
+	for (auto _ : state)
+	{
+		auto data = layout.serialize(text);
+		benchmark::DoNotOptimize(data);
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(serializeLayout)->Unit(benchmark::kMillisecond);
+
+
+BENCHMARK_MAIN();
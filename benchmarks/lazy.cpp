@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "unicode/string_view.hpp"
+#include "unicode/lazy_layout.hpp"
+#include "text.hpp"
+
+/// Maximal size of text in bytes
+static const size_t maxTextSize = getTextSize(size_t(1) << 28);
+
+/// Number of characters, read after construction of view
+constexpr size_t prefix_characters = 256;
+
+/// Construct view and read its first characters
+template<typename Layout>
+static void timeToFirstCharacters(benchmark::State& state)
+{
+	auto size = size_t(state.range(0));
+	if (size > maxTextSize)
+	{
+		state.SkipWithError("text is bigger than UNICODE_BENCHMARK_BYTES");
+		return;
+	}
+
+	auto &text = getText(size);
+	for (auto _ : state)
+	{
+		unicode::basic_string_view<Layout> view = text;
+		benchmark::DoNotOptimize(view.front());
+		for (size_t i = 1; i < prefix_characters; ++i)
+		{
+			benchmark::DoNotOptimize(view[i]);
+		}
+	}
+}
+
+BENCHMARK_TEMPLATE(timeToFirstCharacters, unicode::layout)
+	->Arg(1 << 20)->Arg(1 << 24)->Arg(200 << 20)
+	->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(timeToFirstCharacters, unicode::lazy_layout)
+	->Arg(1 << 20)->Arg(1 << 24)->Arg(200 << 20)
+	->Unit(benchmark::kMicrosecond);
+
+/// Construct view and iterate over all of its characters
+template<typename Layout>
+static void fullIteration(benchmark::State& state)
+{
+	auto &text = getText(state.range(0));
+	for (auto _ : state)
+	{
+		unicode::basic_string_view<Layout> view = text;
+		for (auto c : view)
+		{
+			benchmark::DoNotOptimize(c);
+		}
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+BENCHMARK_TEMPLATE(fullIteration, unicode::layout)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(fullIteration, unicode::lazy_layout)->Arg(1 << 20);
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include "unicode/mapped_string_view.hpp"
+#include "text.hpp"
+
+/// Size of benchmark text in bytes
+static const size_t textSize = getTextSize(size_t(1) << 26);
+
+/// Write benchmark text to temporary file, removing its sidecar
+static std::filesystem::path writeText()
+{
+	auto path = 
+		std::filesystem::temp_directory_path() / "unicode_mapped_benchmark.txt";
+	auto &text = getText(textSize);
+	std::ofstream(path, std::ios::binary).write(text.data(), text.size());
+	std::filesystem::remove(unicode::mapped_string_view::sidecar_path(path));
+	return path;
+}
+
+/// Start by reading file into memory and segmenting it
+static void startupReadFile(benchmark::State& state)
+{
+	auto path = writeText();
+	for (auto _ : state)
+	{
+		auto text = readFile(path.string());
+		unicode::string_view view(text);
+		benchmark::DoNotOptimize(view.size());
+	}
+	state.SetBytesProcessed(state.iterations() * getText(textSize).size());
+}
+BENCHMARK(startupReadFile)->Unit(benchmark::kMillisecond);
+
+/// Start by mapping file and loading its sidecar
+static void startupMapped(benchmark::State& state)
+{
+	auto path = writeText();
+	// Build sidecar
+	unicode::mapped_string_view{path};
+	for (auto _ : state)
+	{
+		unicode::mapped_string_view view(path);
+		assert(view.layout_loaded() && "sidecar is not loaded");
+		benchmark::DoNotOptimize(view.size());
+	}
+	state.SetBytesProcessed(state.iterations() * getText(textSize).size());
+}
+BENCHMARK(startupMapped)->Unit(benchmark::kMillisecond);
+
+/// Access random characters of mapped file
+static void randomAccessMapped(benchmark::State& state)
+{
+	auto path = writeText();
+	unicode::mapped_string_view view(path);
+	std::mt19937 random(42);
+	std::uniform_int_distribution<size_t> index(0, view.size() - 1);
+	for (auto _ : state)
+	{
+		auto character = view[index(random)];
+		benchmark::DoNotOptimize(character);
+	}
+}
+BENCHMARK(randomAccessMapped);
+
+
+BENCHMARK_MAIN();
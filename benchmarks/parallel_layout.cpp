@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "unicode/layout.hpp"
+#include "text.hpp"
+
+/// Size of benchmark text in bytes
+static const size_t textSize = getTextSize(size_t(1) << 28);
+
+/// Build layout on single thread
+static void serialLayout(benchmark::State& state)
+{
+	auto &text = getText(textSize, "\n");
+	for (auto _ : state)
+	{
+		auto layout = unicode::layout::of(text);
+		benchmark::DoNotOptimize(layout);
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(serialLayout)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// Build layout on specified number of threads
+static void parallelLayout(benchmark::State& state)
+{
+	auto &text = getText(textSize, "\n");
+	for (auto _ : state)
+	{
+		auto layout = unicode::layout::parallel_of(text, state.range(0));
+		benchmark::DoNotOptimize(layout);
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(parallelLayout)
+	->RangeMultiplier(2)->Range(1, 16)
+	->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "unicode/algorithm.hpp"
+#include "text.hpp"
+
+/// Size of benchmark text in bytes
+static const size_t textSize = getTextSize(size_t(1) << 30);
+
+/// Get whitespace separated words of benchmark text
+static const std::vector<std::string_view> &getWords()
+{
+	static const std::vector<std::string_view> words = []
+	{
+		std::string_view text = getText(textSize, "\n");
+		std::vector<std::string_view> words;
+		size_t start = 0;
+		while (start < text.size())
+		{
+			start = text.find_first_not_of(" \t\r\n", start);
+			if (start == text.npos) { break; }
+			auto end = std::min(text.find_first_of(" \t\r\n", start), text.size());
+			words.push_back(text.substr(start, end - start));
+			start = end;
+		}
+		return words;
+	}();
+	return words;
+}
+
+/// Sort words of replicated corpora on specified number of threads
+static void parallelSort(benchmark::State& state)
+{
+	auto &words = getWords();
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		auto copy = words;
+		state.ResumeTiming();
+
+		unicode::parallel_sort(copy, state.range(0));
+		benchmark::DoNotOptimize(copy.data());
+	}
+	state.SetItemsProcessed(state.iterations() * words.size());
+	state.SetBytesProcessed(state.iterations() * getText(textSize, "\n").size());
+}
+BENCHMARK(parallelSort)
+	->DenseRange(1, std::max(1u, std::thread::hardware_concurrency()))
+	->Unit(benchmark::kSecond)
+	->UseRealTime();
+
+
+BENCHMARK_MAIN();
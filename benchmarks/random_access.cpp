@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "unicode/string_view.hpp"
+#include "text.hpp"
+
+/// Maximal size of text in bytes
+static const size_t maxTextSize = getTextSize(size_t(1) << 30);
+
+/// Get character at random index
+template<typename Layout>
+static void randomAccess(benchmark::State& state)
+{
+	auto size = size_t(state.range(0));
+	if (size > maxTextSize)
+	{
+		state.SkipWithError("text is bigger than UNICODE_BENCHMARK_BYTES");
+		return;
+	}
+
+	unicode::basic_string_view<Layout> view = getText(size);
+
+	std::mt19937_64 random(42);
+	std::vector<size_t> indexes(1 << 16);
+	for (auto &index : indexes) { index = random() % view.size(); }
+
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		auto c = view[indexes[i++ % indexes.size()]];
+		benchmark::DoNotOptimize(c);
+	}
+	state.counters["characters"] = view.size();
+	state.counters["layout_bytes"] = view.memory_usage();
+	if constexpr (requires { Layout::index_type::node_compare(); })
+	{
+		state.SetLabel(Layout::index_type::node_compare());
+	}
+}
+
+using binary_search_layout = 
+	unicode::basic_layout<unicode::offset_index::binary_search>;
+using btree_layout = unicode::basic_layout<unicode::offset_index::btree>;
+
+BENCHMARK_TEMPLATE(randomAccess, binary_search_layout)
+	->Arg(1 << 10)->Arg(1 << 20)->Arg(1 << 30);
+BENCHMARK_TEMPLATE(randomAccess, btree_layout)
+	->Arg(1 << 10)->Arg(1 << 20)->Arg(1 << 30);
+
+
+BENCHMARK_MAIN();
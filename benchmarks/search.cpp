@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+
+#include "unicode/string_view.hpp"
+#include "text.hpp"
+
+/// Needle, that isn't found in any corpus
+static constexpr std::string_view missing = "\xe2\x80\x8b\xe2\x80\x8b";
+
+/// Count non-overlapping occurrences of needle in bytes
+static size_t countBytes(std::string_view bytes, std::string_view needle)
+{
+	size_t count = 0;
+	for (
+		auto position = bytes.find(needle); 
+		position != bytes.npos; 
+		position = bytes.find(needle, position + needle.size())
+	)
+	{
+		++count;
+	}
+	return count;
+}
+
+/// Benchmarks find all occurrences of a frequent word 
+/// and look for a missing one, comparing with byte search
+#define BENCHMARK_LANGUAGE(name, word) \
+	static void name ## FindAll(benchmark::State& state) \
+	{ \
+		auto content = readFile("./data/" #name "/wiki.txt"); \
+		unicode::string_view view = content; \
+		for (auto _ : state) \
+		{ \
+			benchmark::DoNotOptimize(view.find_all(word)); \
+		} \
+		state.SetBytesProcessed(state.iterations() * content.size()); \
+		state.counters["matches"] = double(view.find_all(word).size()); \
+	} \
+	BENCHMARK(name ## FindAll); \
+	static void name ## StandardFindAll(benchmark::State& state) \
+	{ \
+		auto content = readFile("./data/" #name "/wiki.txt"); \
+		for (auto _ : state) \
+		{ \
+			benchmark::DoNotOptimize(countBytes(content, word)); \
+		} \
+		state.SetBytesProcessed(state.iterations() * content.size()); \
+		state.counters["matches"] = double(countBytes(content, word)); \
+	} \
+	BENCHMARK(name ## StandardFindAll); \
+	static void name ## ContainsMissing(benchmark::State& state) \
+	{ \
+		auto content = readFile("./data/" #name "/wiki.txt"); \
+		unicode::string_view view = content; \
+		for (auto _ : state) \
+		{ \
+			benchmark::DoNotOptimize(view.contains(missing)); \
+		} \
+		state.SetBytesProcessed(state.iterations() * content.size()); \
+	} \
+	BENCHMARK(name ## ContainsMissing); \
+	static void name ## StandardContainsMissing(benchmark::State& state) \
+	{ \
+		auto content = readFile("./data/" #name "/wiki.txt"); \
+		std::string_view bytes = content; \
+		for (auto _ : state) \
+		{ \
+			benchmark::DoNotOptimize(bytes.find(missing) != bytes.npos); \
+		} \
+		state.SetBytesProcessed(state.iterations() * content.size()); \
+	} \
+	BENCHMARK(name ## StandardContainsMissing);
+
+/* 1-st type of texts */
+BENCHMARK_LANGUAGE(english, " the ")
+BENCHMARK_LANGUAGE(german, " der ")
+
+/* 2-nd type of texts */
+BENCHMARK_LANGUAGE(russian, " и ")
+BENCHMARK_LANGUAGE(french, " de ")
+
+/* 3-rd type of texts */
+BENCHMARK_LANGUAGE(chinese, "的")
+BENCHMARK_LANGUAGE(japanese, "の")
+BENCHMARK_LANGUAGE(korean, "이")
+
+BENCHMARK_MAIN();
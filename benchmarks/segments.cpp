@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <type_traits>
+
+#include "unicode/segment_view.hpp"
+
+#include "../sources/icu.hpp"
+#include "text.hpp"
+
+/// Size of benchmark text in bytes
+static const size_t textSize = getTextSize(size_t(1) << 22);
+
+/// Get factory of ICU break iterators for view
+template<typename View>
+static BreakIteratorFactory getFactory()
+{
+	using unicode::segment;
+	using unicode::segment_layout;
+	using layout = typename View::layout_type;
+	if constexpr (std::is_same_v<layout, segment_layout<segment::word>>)
+	{
+		return icu::BreakIterator::createWordInstance;
+	}
+	else if constexpr (
+		std::is_same_v<layout, segment_layout<segment::sentence>>
+	)
+	{
+		return icu::BreakIterator::createSentenceInstance;
+	}
+	else { return icu::BreakIterator::createLineInstance; }
+}
+
+/// Iterate over segments with ICU break iterator
+template<typename View>
+static void iterateICU(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	auto utext = openUText(text);
+	auto it = getBreakIterator(utext.get(), getFactory<View>());
+	for (auto _ : state)
+	{
+		for (
+			auto start = it->first(), end = it->next();
+			end != icu::BreakIterator::DONE;
+			start = end, end = it->next()
+		)
+		{
+			auto segment = std::string_view(text.data() + start, end - start);
+			benchmark::DoNotOptimize(segment);
+		}
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+/// Build view over segments
+template<typename View>
+static void buildView(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	for (auto _ : state)
+	{
+		View view = text;
+		benchmark::DoNotOptimize(view.size());
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+	state.counters["index_bytes"] = View(text).memory_usage();
+}
+
+/// Iterate over segments of view
+template<typename View>
+static void iterateView(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	View view = text;
+	for (auto _ : state)
+	{
+		for (auto segment : view) { benchmark::DoNotOptimize(segment); }
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+/// Get random segment with ICU, counting segments from the beginning
+template<typename View>
+static void randomAccessICU(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	auto utext = openUText(text);
+	auto it = getBreakIterator(utext.get(), getFactory<View>());
+	View view = text;
+	std::mt19937 random(42);
+	std::uniform_int_distribution<size_t> index(0, view.size() - 1);
+	for (auto _ : state)
+	{
+		auto start = it->first();
+		for (auto i = index(random); i != 0; --i) { start = it->next(); }
+		auto segment = std::string_view(
+			text.data() + start, 
+			it->next() - start
+		);
+		benchmark::DoNotOptimize(segment);
+	}
+}
+
+/// Get random segment of view
+template<typename View>
+static void randomAccessView(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	View view = text;
+	std::mt19937 random(42);
+	std::uniform_int_distribution<size_t> index(0, view.size() - 1);
+	for (auto _ : state)
+	{
+		auto segment = view[index(random)];
+		benchmark::DoNotOptimize(segment);
+	}
+}
+
+#define BENCHMARK_SEGMENTS(View) \
+	BENCHMARK_TEMPLATE(iterateICU, View)->Unit(benchmark::kMillisecond); \
+	BENCHMARK_TEMPLATE(buildView, View)->Unit(benchmark::kMillisecond); \
+	BENCHMARK_TEMPLATE(iterateView, View)->Unit(benchmark::kMillisecond); \
+	BENCHMARK_TEMPLATE(randomAccessICU, View)->Unit(benchmark::kMicrosecond); \
+	BENCHMARK_TEMPLATE(randomAccessView, View);
+
+BENCHMARK_SEGMENTS(unicode::word_view)
+BENCHMARK_SEGMENTS(unicode::sentence_view)
+BENCHMARK_SEGMENTS(unicode::line_break_view)
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,184 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <string>
+
+#include "unicode/string_view.hpp"
+#include "text.hpp"
+
+/// Number of allocations with global operator new
+static size_t allocations = 0;
+
+// Replacements are not inlined, so that GCC doesn't pair malloc and free
+// with library operators and warn about mismatch
+
+[[gnu::noinline]]
+void *operator new(std::size_t size)
+{
+	++allocations;
+	if (auto p = std::malloc(size)) { return p; }
+	throw std::bad_alloc();
+}
+
+[[gnu::noinline]]
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+	++allocations;
+	auto align = std::max(sizeof(void *), size_t(alignment));
+	if (auto p = std::aligned_alloc(align, (size + align - 1) / align * align))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+[[gnu::noinline]]
+void operator delete(void *p) noexcept { std::free(p); }
+
+[[gnu::noinline]]
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+
+[[gnu::noinline]]
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+[[gnu::noinline]]
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept 
+{ 
+	std::free(p); 
+}
+
+/// Number of short strings
+constexpr size_t count = 1000000;
+
+/// Get short strings: words of all corpora, repeated up to count
+static const std::vector<std::string_view> &getWords()
+{
+	static const std::string text = []
+	{
+		std::string text;
+		for (
+			auto language : {
+				"english", "german", "russian", "french", 
+				"chinese", "japanese", "korean"
+			}
+		)
+		{
+			text += readFile(std::string("./data/") + language + "/wiki.txt");
+		}
+		return text;
+	}();
+	static const std::vector<std::string_view> words = []
+	{
+		std::vector<std::string_view> words;
+		for (size_t start = 0; start < text.size();)
+		{
+			auto end = std::min(text.find_first_of(" \n", start), text.size());
+			// Texts without spaces are split into labels of 12 bytes
+			end = std::min(end, start + 12);
+			while (end < text.size() && (uint8_t(text[end]) & 0xC0) == 0x80) 
+			{ 
+				++end; 
+			}
+			if (end != start) 
+			{ 
+				words.push_back(std::string_view(text).substr(start, end - start)); 
+			}
+			start = end + 1;
+		}
+		words.reserve(count);
+		for (size_t i = 0; words.size() < count; ++i) 
+		{ 
+			words.push_back(words[i]); 
+		}
+		words.resize(count);
+		return words;
+	}();
+	return words;
+}
+
+/// Get ASCII keys, e.g. user_123456
+static const std::vector<std::string> &getKeys()
+{
+	static const std::vector<std::string> keys = []
+	{
+		std::vector<std::string> keys;
+		keys.reserve(count);
+		for (size_t i = 0; i < count; ++i) 
+		{ 
+			keys.push_back("user_" + std::to_string(i)); 
+		}
+		return keys;
+	}();
+	return keys;
+}
+
+/// Build views over strings, counting allocations
+template<typename Strings>
+static void buildViews(benchmark::State& state, const Strings &strings)
+{
+	auto before = allocations;
+	for (auto _ : state)
+	{
+		for (auto &string : strings)
+		{
+			unicode::string_view view = string;
+			benchmark::DoNotOptimize(view);
+		}
+	}
+	auto views = state.iterations() * strings.size();
+	state.counters["allocations_per_view"] = 
+		double(allocations - before) / views;
+	state.counters["view_bytes"] = sizeof(unicode::string_view);
+	state.SetItemsProcessed(views);
+}
+
+/// Keep views over all strings, reporting memory per view:
+/// size of view itself and memory, allocated for its layout
+template<typename Strings>
+static void keepViews(benchmark::State& state, const Strings &strings)
+{
+	size_t memory = 0;
+	for (auto _ : state)
+	{
+		std::vector<unicode::string_view> views(strings.begin(), strings.end());
+		memory = views.capacity() * sizeof(unicode::string_view);
+		for (auto &view : views) { memory += view.memory_usage(); }
+		benchmark::DoNotOptimize(views.data());
+	}
+	state.counters["bytes_per_view"] = double(memory) / strings.size();
+	state.SetItemsProcessed(state.iterations() * strings.size());
+}
+
+/// Build views over words of different languages
+static void shortWords(benchmark::State& state)
+{
+	buildViews(state, getWords());
+}
+BENCHMARK(shortWords)->Unit(benchmark::kMillisecond);
+
+/// Build views over ASCII keys
+static void shortKeys(benchmark::State& state)
+{
+	buildViews(state, getKeys());
+}
+BENCHMARK(shortKeys)->Unit(benchmark::kMillisecond);
+
+/// Keep views over words of different languages
+static void keptWords(benchmark::State& state)
+{
+	keepViews(state, getWords());
+}
+BENCHMARK(keptWords)->Unit(benchmark::kMillisecond);
+
+/// Keep views over ASCII keys
+static void keptKeys(benchmark::State& state)
+{
+	keepViews(state, getKeys());
+}
+BENCHMARK(keptKeys)->Unit(benchmark::kMillisecond);
+
+
+BENCHMARK_MAIN();
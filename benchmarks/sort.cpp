@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+#include <sstream>
+#include <vector>
+
+#include "unicode/string_view.hpp"
+#include "unicode/algorithm.hpp"
+#include "unicode/utf8/comparator.hpp"
+#include "text.hpp"
+
+/// Get whitespace separated words of all corpora
+static const std::vector<std::string> &getWords()
+{
+	static const std::vector<std::string> words = []
+	{
+		std::vector<std::string> words;
+		for (
+			auto language : {
+				"english", "german", "russian", "french", 
+				"chinese", "japanese", "korean"
+			}
+		)
+		{
+			std::istringstream stream(
+				readFile(std::string("./data/") + language + "/wiki.txt")
+			);
+			for (std::string word; stream >> word;) { words.push_back(word); }
+		}
+		return words;
+	}();
+	return words;
+}
+
+using namespace unicode;
+
+/// Sort with std::sort and unicode::string_view::operator<
+static void stdSortStringView(benchmark::State& state)
+{
+	auto &words = getWords();
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::vector<unicode::string_view> views(words.begin(), words.end());
+		state.ResumeTiming();
+
+		std::sort(views.begin(), views.end());
+		benchmark::DoNotOptimize(views.data());
+	}
+	state.SetItemsProcessed(state.iterations() * words.size());
+}
+BENCHMARK(stdSortStringView)->Unit(benchmark::kMillisecond);
+
+/// Sort with std::sort and reusable comparator
+static void stdSortComparator(benchmark::State& state)
+{
+	auto &words = getWords();
+	utf8::comparator comparator;
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::vector<std::string_view> views(words.begin(), words.end());
+		state.ResumeTiming();
+
+		std::sort(views.begin(), views.end(), comparator);
+		benchmark::DoNotOptimize(views.data());
+	}
+	state.SetItemsProcessed(state.iterations() * words.size());
+}
+BENCHMARK(stdSortComparator)->Unit(benchmark::kMillisecond);
+
+/// Sort with sort keys
+static void unicodeSort(benchmark::State& state)
+{
+	auto &words = getWords();
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::vector<std::string_view> views(words.begin(), words.end());
+		state.ResumeTiming();
+
+		unicode::sort(views);
+		benchmark::DoNotOptimize(views.data());
+	}
+	state.SetItemsProcessed(state.iterations() * words.size());
+}
+BENCHMARK(unicodeSort)->Unit(benchmark::kMillisecond);
+
+/// Stable sort with sort keys
+static void unicodeStableSort(benchmark::State& state)
+{
+	auto &words = getWords();
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::vector<std::string_view> views(words.begin(), words.end());
+		state.ResumeTiming();
+
+		unicode::stable_sort(views);
+		benchmark::DoNotOptimize(views.data());
+	}
+	state.SetItemsProcessed(state.iterations() * words.size());
+}
+BENCHMARK(unicodeStableSort)->Unit(benchmark::kMillisecond);
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "unicode/grapheme_stream.hpp"
+#include "unicode/layout.hpp"
+#include "text.hpp"
+
+/// Size of benchmark text in bytes
+static const size_t textSize = getTextSize(size_t(1) << 26);
+
+/// Count characters of whole text at once
+static void countWhole(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	for (auto _ : state)
+	{
+		auto layout = unicode::layout::of(text);
+		benchmark::DoNotOptimize(layout.characters());
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(countWhole)->Unit(benchmark::kMillisecond);
+
+/// Count characters of text, pushed to stream in chunks
+static void countStream(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	auto chunk = size_t(state.range(0));
+	unicode::grapheme_stream stream;
+	for (auto _ : state)
+	{
+		size_t characters = 0;
+		auto count = [&](unicode::character_view) { ++characters; };
+		for (size_t offset = 0; offset < text.size(); offset += chunk)
+		{
+			stream.push(std::string_view(text).substr(offset, chunk), count);
+		}
+		stream.finish(count);
+		benchmark::DoNotOptimize(characters);
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(countStream)
+	->RangeMultiplier(4)->Range(1 << 10, 1 << 16)
+	->Unit(benchmark::kMillisecond);
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "unicode/string.hpp"
+#include "text.hpp"
+
+/// Size of benchmark text in bytes
+static const size_t textSize = getTextSize(size_t(1) << 14);
+
+/// Append characters of text one by one, keeping layout up to date
+static void stringPushBack(benchmark::State& state)
+{
+	unicode::string_view text = getText(textSize);
+	for (auto _ : state)
+	{
+		unicode::string str;
+		for (auto c : text) { str.push_back(c); }
+		benchmark::DoNotOptimize(str);
+	}
+	state.SetBytesProcessed(state.iterations() * getText(textSize).size());
+}
+BENCHMARK(stringPushBack)->Unit(benchmark::kMillisecond);
+
+/// Append characters of text to std::string and get layout once at the end
+static void stdStringPushBackThenLayout(benchmark::State& state)
+{
+	unicode::string_view text = getText(textSize);
+	for (auto _ : state)
+	{
+		std::string str;
+		for (auto c : text) { str += c; }
+		auto layout = unicode::layout::of(str);
+		benchmark::DoNotOptimize(layout);
+	}
+	state.SetBytesProcessed(state.iterations() * getText(textSize).size());
+}
+BENCHMARK(stdStringPushBackThenLayout)->Unit(benchmark::kMillisecond);
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+
+#include "unicode/string_view.hpp"
+#include "text.hpp"
+
+/// Size of benchmark text in bytes
+static const size_t textSize = getTextSize(size_t(1) << 24);
+
+/// Slice view with shared layout
+static void substrShared(benchmark::State& state)
+{
+	unicode::string_view view = getText(textSize);
+	auto count = size_t(state.range(0));
+	std::mt19937 random(42);
+	std::uniform_int_distribution<size_t> index(0, view.size() - count);
+	for (auto _ : state)
+	{
+		auto slice = view.substr(index(random), count);
+		benchmark::DoNotOptimize(slice);
+	}
+}
+BENCHMARK(substrShared)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+/// Slice view by segmenting bytes of slice again
+static void substrSegmented(benchmark::State& state)
+{
+	unicode::string_view view = getText(textSize);
+	auto count = size_t(state.range(0));
+	std::mt19937 random(42);
+	std::uniform_int_distribution<size_t> index(0, view.size() - count);
+	for (auto _ : state)
+	{
+		auto first = index(random);
+		auto begin = view.index_to_byte(first);
+		auto end = view.index_to_byte(first + count);
+		unicode::string_view slice = 
+			std::string_view(view).substr(begin, end - begin);
+		benchmark::DoNotOptimize(slice);
+	}
+}
+BENCHMARK(substrSegmented)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+/// Copy view with shared layout
+static void copyShared(benchmark::State& state)
+{
+	unicode::string_view view = getText(textSize);
+	for (auto _ : state)
+	{
+		auto copy = view;
+		benchmark::DoNotOptimize(copy);
+	}
+}
+BENCHMARK(copyShared);
+
+/// Copy view, that owns its layout
+static void copyOwned(benchmark::State& state)
+{
+	unicode::basic_string_view<unicode::layout> view = getText(textSize);
+	for (auto _ : state)
+	{
+		auto copy = view;
+		benchmark::DoNotOptimize(copy);
+	}
+}
+BENCHMARK(copyOwned)->Unit(benchmark::kMicrosecond);
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/// Read whole file content
+inline std::string readFile(const std::string &path)
+{
+	std::ifstream file(path);
+	assert(file && "Can't open file");
+	std::string content((std::istreambuf_iterator<char>(file)),
+		(std::istreambuf_iterator<char>()));
+	return content;
+}
+
+/// Get size of benchmark text in bytes.
+/// Can be changed with UNICODE_BENCHMARK_BYTES environment variable
+inline size_t getTextSize(size_t defaultSize)
+{
+	if (auto bytes = std::getenv("UNICODE_BENCHMARK_BYTES"))
+	{
+		return std::stoull(bytes);
+	}
+	return defaultSize;
+}
+
+/// Get mixed-script text of specified size, that repeats corpora
+/// of all languages, each followed by separator.
+/// Text is cut at character boundary and built once for each size
+inline const std::string &getText(size_t size, std::string_view separator = "")
+{
+	static std::map<std::pair<size_t, std::string>, std::string> texts;
+	auto &text = texts[{size, std::string(separator)}];
+	if (!text.empty() || size == 0) { return text; }
+
+	std::string corpora;
+	for (
+		auto language : {
+			"english", "german", "russian", "french",
+			"chinese", "japanese", "korean"
+		}
+	)
+	{
+		corpora += readFile(std::string("./data/") + language + "/wiki.txt");
+		corpora += separator;
+	}
+
+	text.reserve(size + corpora.size());
+	while (text.size() < size) { text += corpora; }
+
+	// Cut at character boundary
+	auto end = size;
+	while (end > 0 && (uint8_t(text[end]) & 0xC0) == 0x80) { --end; }
+	text.resize(end);
+	return text;
+}
@@ -0,0 +1,136 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+
+#include "unicode/string.hpp"
+#include "unicode/string_view.hpp"
+#include "text.hpp"
+
+/// Size of benchmark text in bytes
+static const size_t textSize = getTextSize(size_t(1) << 24);
+
+/// Build layout without translation columns
+static void buildLayout(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	for (auto _ : state)
+	{
+		auto layout = unicode::layout::of(text);
+		benchmark::DoNotOptimize(layout);
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+	state.counters["layout_bytes"] = unicode::layout::of(text).memory_usage();
+}
+BENCHMARK(buildLayout)->Unit(benchmark::kMillisecond);
+
+/// Build layout with translation columns
+static void buildTranslationLayout(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	for (auto _ : state)
+	{
+		auto layout = unicode::translation_layout::of(text);
+		benchmark::DoNotOptimize(layout);
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+	state.counters["layout_bytes"] = 
+		unicode::translation_layout::of(text).memory_usage();
+}
+BENCHMARK(buildTranslationLayout)->Unit(benchmark::kMillisecond);
+
+/// Translate random offsets with view
+#define BENCHMARK_TRANSLATION(name, size, translate) \
+	static void name(benchmark::State& state) \
+	{ \
+		auto &text = getText(textSize); \
+		unicode::translation_string_view view = text; \
+		std::mt19937 random(42); \
+		std::uniform_int_distribution<size_t> offset(0, size); \
+		for (auto _ : state) \
+		{ \
+			benchmark::DoNotOptimize(view.translate(offset(random))); \
+		} \
+	} \
+	BENCHMARK(name);
+
+BENCHMARK_TRANSLATION(indexToByte, view.size(), index_to_byte)
+BENCHMARK_TRANSLATION(byteToIndex, text.size(), byte_to_index)
+BENCHMARK_TRANSLATION(indexToCodePoint, view.size(), index_to_code_point)
+BENCHMARK_TRANSLATION(
+	codePointToIndex, 
+	view.index_to_code_point(view.size()), 
+	code_point_to_index
+)
+BENCHMARK_TRANSLATION(indexToUTF16, view.size(), index_to_utf16)
+BENCHMARK_TRANSLATION(
+	utf16ToIndex, 
+	view.index_to_utf16(view.size()), 
+	utf16_to_index
+)
+
+/// Translate random UTF-16 offsets by scanning characters from the start
+static void utf16ToIndexLinear(benchmark::State& state)
+{
+	auto &text = getText(textSize);
+	unicode::translation_string_view view = text;
+	std::mt19937 random(42);
+	std::uniform_int_distribution<size_t> offset(
+		0, view.index_to_utf16(view.size())
+	);
+	for (auto _ : state)
+	{
+		auto target = offset(random);
+		size_t units = 0;
+		size_t index = 0;
+		for (auto character : view)
+		{
+			for (size_t i = 0; i < character.size(); ++i)
+			{
+				auto byte = uint8_t(character[i]);
+				if ((byte & 0xC0) != 0x80) { units += byte >= 0xF0 ? 2 : 1; }
+			}
+			if (units > target) { break; }
+			++index;
+		}
+		benchmark::DoNotOptimize(index);
+	}
+}
+BENCHMARK(utf16ToIndexLinear)->Unit(benchmark::kMillisecond);
+
+
+/// Insert and erase a character at random positions of string 
+/// with translation columns, that are updated incrementally
+static void editTranslationString(benchmark::State& state)
+{
+	unicode::basic_string<unicode::translation_layout> str = getText(textSize);
+	std::mt19937 random(42);
+	std::uniform_int_distribution<size_t> index(0, str.size() - 1);
+	for (auto _ : state)
+	{
+		auto position = index(random);
+		str.insert(position, "é");
+		str.erase(position, 1);
+	}
+	state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(editTranslationString)->Unit(benchmark::kMillisecond);
+
+/// Insert and erase a character at random positions of string 
+/// without translation columns
+static void editString(benchmark::State& state)
+{
+	unicode::basic_string<unicode::layout> str = getText(textSize);
+	std::mt19937 random(42);
+	std::uniform_int_distribution<size_t> index(0, str.size() - 1);
+	for (auto _ : state)
+	{
+		auto position = index(random);
+		str.insert(position, "é");
+		str.erase(position, 1);
+	}
+	state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(editString)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
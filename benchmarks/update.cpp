@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+
+#include "unicode/string_view.hpp"
+#include "text.hpp"
+
+/// Size of document in bytes
+constexpr size_t document_size = 10 << 20;
+
+/// Get mixed-script document, made of all corpora
+static std::string getDocument()
+{
+	std::string corpora;
+	for (
+		auto language : {
+			"english", "russian", "chinese", "german", 
+			"japanese", "french", "korean"
+		}
+	)
+	{
+		corpora += readFile(std::string("./data/") + language + "/wiki.txt");
+	}
+
+	std::string document;
+	document.reserve(document_size + corpora.size());
+	while (document.size() < document_size) { document += corpora; }
+	return document;
+}
+
+/// Get random offset of code point in document
+static size_t randomOffset(const std::string &document, std::mt19937_64 &random)
+{
+	auto offset = random() % document.size();
+	while ((uint8_t(document[offset]) & 0xC0) == 0x80) { --offset; }
+	return offset;
+}
+
+/// Insert character into document and update layout incrementally
+static void incrementalInsert(benchmark::State& state)
+{
+	auto document = getDocument();
+	unicode::string_view view = document;
+	std::mt19937_64 random(42);
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		auto offset = randomOffset(document, random);
+		document.insert(offset, "ы");
+		state.ResumeTiming();
+		view.update(document, {offset, 0}, 2);
+		benchmark::DoNotOptimize(view);
+	}
+	state.counters["layout_bytes_per_byte"] = 
+		double(view.memory_usage()) / document.size();
+}
+BENCHMARK(incrementalInsert)->Unit(benchmark::kMicrosecond);
+
+/// Insert character into document and rebuild layout
+static void fullUpdateInsert(benchmark::State& state)
+{
+	auto document = getDocument();
+	unicode::string_view view = document;
+	std::mt19937_64 random(42);
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		auto offset = randomOffset(document, random);
+		document.insert(offset, "ы");
+		state.ResumeTiming();
+		view = document;
+		benchmark::DoNotOptimize(view);
+	}
+}
+BENCHMARK(fullUpdateInsert)->Unit(benchmark::kMicrosecond);
+
+
+BENCHMARK_MAIN();
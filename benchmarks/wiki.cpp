@@ -35,7 +35,18 @@ using namespace unicode;
 			benchmark::DoNotOptimize(c); \
 		} \
 	} \
-	BENCHMARK(name);
+	BENCHMARK(name); \
+	static void name ## Layout(benchmark::State& state) \
+	{ \
+		auto content = readFile("./data/" #name "/wiki.txt"); \
+		for (auto _ : state) \
+		{ \
+			auto layout = layout::of(content); \
+			benchmark::DoNotOptimize(layout); \
+		} \
+		state.SetBytesProcessed(state.iterations() * content.size()); \
+	} \
+	BENCHMARK(name ## Layout);
 
 /* 1-st type of texts */
 BENCHMARK_LANGUAGE(english)
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <concepts>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "unicode/sort_key.hpp"
+
+namespace unicode
+{
+
+/// Random access range of strings, that can be reordered in place
+template<typename Range>
+concept sortable_string_range = 
+	std::ranges::random_access_range<Range> &&
+	std::ranges::sized_range<Range> &&
+	std::permutable<std::ranges::iterator_t<Range>> &&
+	std::convertible_to<
+		std::ranges::range_reference_t<Range>, 
+		std::string_view
+	>;
+
+namespace utility
+{
+
+/// Get bytes of each string inside of range
+template<sortable_string_range Range>
+std::vector<std::string_view> string_views(Range &&range)
+{
+	std::vector<std::string_view> strings;
+	strings.reserve(std::ranges::size(range));
+	for (auto &&str : range) 
+	{ 
+		strings.push_back(static_cast<std::string_view>(str)); 
+	}
+	return strings;
+}
+
+/// Reorder range, so that i-th element becomes element at order[i]
+template<std::ranges::random_access_range Range>
+void apply_permutation(Range &&range, std::vector<size_t> order)
+{
+	auto first = std::ranges::begin(range);
+	for (size_t start = 0; start < order.size(); ++start)
+	{
+		if (order[start] == start) { continue; }
+
+		// Rotate elements along the cycle, marking visited positions
+		auto value = std::ranges::iter_move(first + start);
+		auto current = start;
+		while (order[current] != start)
+		{
+			auto next = order[current];
+			*(first + current) = std::ranges::iter_move(first + next);
+			order[current] = current;
+			current = next;
+		}
+		*(first + current) = std::move(value);
+		order[current] = current;
+	}
+}
+
+} // namespace utility
+
+/// Sort strings with default locale comparison rules.
+/// Computes sort keys once, instead of collating on each comparison
+template<sortable_string_range Range>
+void sort(Range &&range)
+{
+	auto strings = utility::string_views(range);
+	auto order = sort_keys(strings).order();
+	strings.clear();
+	utility::apply_permutation(range, std::move(order));
+}
+
+/// Sort strings with default locale comparison rules, 
+/// keeping order of equal strings
+template<sortable_string_range Range>
+void stable_sort(Range &&range)
+{
+	auto strings = utility::string_views(range);
+	auto order = sort_keys(strings).order(/*stable*/true);
+	strings.clear();
+	utility::apply_permutation(range, std::move(order));
+}
+
+/// Get indexes of strings in ascending collation order.
+/// Keys are computed and merge sorted on specified number of threads.
+/// Order is stable
+std::vector<size_t> parallel_sorted_order(
+	std::span<const std::string_view> strings,
+	size_t threads = std::thread::hardware_concurrency()
+);
+
+/// Sort strings with default locale comparison rules on multiple threads,
+/// keeping order of equal strings
+template<sortable_string_range Range>
+void parallel_sort(
+	Range &&range, 
+	size_t threads = std::thread::hardware_concurrency()
+)
+{
+	auto strings = utility::string_views(range);
+	auto order = parallel_sorted_order(strings, threads);
+	strings.clear();
+	utility::apply_permutation(range, std::move(order));
+}
+
+} // namespace unicode
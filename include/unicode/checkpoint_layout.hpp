@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cassert>
+#include <string_view>
+
+#include "unicode/layout.hpp"
+#include "unicode/utility/packed_vector.hpp"
+
+namespace unicode
+{
+
+/// Sparse layout, that keeps byte offsets of every K-th character only.
+/// Blocks are intervals of K characters between checkpoints.
+/// Characters are found by segmenting at most K characters 
+/// from the nearest checkpoint, so layout refers to its string.
+/// Sequential iteration segments each character once
+class checkpoint_layout
+{
+public:
+	/// Default number of characters between checkpoints
+	static constexpr size_t default_interval = 64;
+
+	/// Layout of empty string
+	checkpoint_layout() { checkpoints.push_back(0); }
+
+	/// Get layout of string with checkpoint every interval characters
+	static checkpoint_layout of(
+		std::string_view bytes, 
+		size_t interval = default_interval
+	);
+
+	/// Rebuild layout after change in string, keeping interval
+	void update(std::string_view bytes) { *this = of(bytes, interval); }
+
+	/// Update layout after bytes in changed range of string 
+	/// were replaced with new_length bytes.
+	/// Checkpoints after change move by characters, so layout is rebuilt
+	void update(std::string_view bytes, byte_range, size_t) { update(bytes); }
+
+	/// Get number of characters between checkpoints
+	size_t checkpoint_interval() const noexcept { return interval; }
+
+	/// Get number of blocks between checkpoints
+	size_t block_count() const noexcept { return checkpoints.size() - 1; }
+
+	/// Get number of characters
+	size_t characters() const noexcept { return character_count; }
+
+	/// Get number of bytes
+	size_t bytes() const noexcept { return checkpoints.back(); }
+
+	/// Get index of block for specified character.
+	/// One past last character belongs to the block after last
+	size_t block_index_for_character(size_t character_index) const noexcept
+	{
+		assert(character_index <= characters() && "out of range");
+		if (character_index == characters()) { return block_count(); }
+		return character_index / interval;
+	}
+
+	/// Get run of characters of same size, that contains character.
+	/// Run of the block after the last one is empty and starts at the end
+	unicode::run run(size_t block_index, size_t character_index) const noexcept
+	{
+		if (block_index == block_count()) 
+		{ 
+			return {block_index, characters(), characters(), bytes(), 0}; 
+		}
+		return find_run(
+			block_index, 
+			block_index * interval, 
+			checkpoints[block_index], 
+			character_index
+		);
+	}
+
+	/// Get run after the given one. Run after the last one is empty
+	unicode::run next(const unicode::run &run) const noexcept
+	{
+		auto block = block_index_for_character(run.last);
+		if (block == block_count()) { return this->run(block, run.last); }
+		return find_run(block, run.last, run.byte_end(), run.last);
+	}
+
+	/// Get run before the given one. 
+	/// Segments block from its checkpoint
+	unicode::run previous(const unicode::run &run) const noexcept
+	{
+		assert(run.first != 0 && "there is no run before the first one");
+		return this->run(block_index_for_character(run.first - 1), run.first - 1);
+	}
+
+	/// Get number of bytes, used by layout
+	size_t memory_usage() const noexcept { return checkpoints.memory_usage(); }
+
+private:
+	/// Segmented string
+	std::string_view text;
+	/// Number of characters between checkpoints
+	size_t interval = default_interval;
+	/// Number of characters
+	size_t character_count = 0;
+	/// Byte offsets of every interval-th character, 
+	/// followed by number of bytes
+	utility::packed_vector checkpoints;
+
+	/// Segment block from character at byte offset 
+	/// until run, containing character, is found
+	unicode::run find_run(
+		size_t block_index,
+		size_t first,
+		size_t byte_offset,
+		size_t character_index
+	) const noexcept;
+};
+
+} // namespace unicode
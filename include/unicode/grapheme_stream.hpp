@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "unicode/character_view.hpp"
+
+namespace unicode
+{
+
+/// Segmenter of UTF-8 text, that comes in chunks of any size.
+/// Chunks may split code points and characters.
+/// Only bytes of the unfinished character are kept between chunks
+class grapheme_stream
+{
+public:
+	/// Segment next chunk of text.
+	/// Calls function(character_view) for each character, it completes.
+	/// Views are valid only during the call
+	template<typename Function>
+	void push(std::string_view chunk, Function &&function)
+	{
+		push(chunk, callback(function));
+	}
+
+	/// End of text. Calls function(character_view) for the last character.
+	/// Stream is ready for the next text after it
+	template<typename Function>
+	void finish(Function &&function)
+	{
+		finish(callback(function));
+	}
+
+	/// Get number of bytes, kept for unfinished character
+	size_t pending_size() const noexcept { return pending.size(); }
+
+private:
+	/// Type-erased reference to function, that takes characters
+	class callback
+	{
+	public:
+		/// Refer to function
+		template<typename Function>
+		explicit callback(Function &function) noexcept
+			: context(
+				const_cast<void *>(
+					static_cast<const void *>(std::addressof(function))
+				)
+			  ),
+			  call(
+				[](void *context, character_view character)
+				{
+					(*static_cast<Function *>(context))(character);
+				}
+			  )
+		{}
+
+		/// Call function
+		void operator()(character_view character) const
+		{
+			call(context, character);
+		}
+
+	private:
+		/// Function itself
+		void *context;
+		/// Caller of function
+		void (*call)(void *, character_view);
+	};
+
+	/// Segment next chunk of text
+	void push(std::string_view chunk, callback emit);
+	/// End of text
+	void finish(callback emit);
+
+	/// Bytes of unfinished character, including incomplete code point
+	std::string pending;
+	/// Number of bytes of incomplete code point at the end of pending
+	size_t incomplete = 0;
+	/// State of segmentation automaton. Zero at the start of text
+	uint8_t state = 0;
+};
+
+} // namespace unicode
@@ -1,41 +1,538 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <span>
 #include <vector>
 #include <string_view>
+#include <thread>
+#include <utility>
 
-#include "unicode/utility/sorted_vector.hpp"
+#include "unicode/offset_index.hpp"
+#include "unicode/utility/packed_vector.hpp"
+#include "unicode/utility/small_vector.hpp"
 
 namespace unicode
 {
 
-/// Contiguous block of characters with same number of bytes per character
-struct block
+/// Consecutive characters with same number of bytes per character
+struct run
 {
-	/// Size of characters inside of block, in bytes
-	size_t character_size = 0;
-	/// Offset of the first byte of block
+	/// Index of block, containing run
+	size_t block = 0;
+	/// Index of the first character
+	size_t first = 0;
+	/// Index of one past last character
+	size_t last = 0;
+	/// Offset of the first byte
 	size_t byte_offset = 0;
+	/// Size of characters, in bytes
+	size_t character_size = 0;
+
+	/// Get offset of the first byte of character inside of run
+	size_t byte_offset_of(size_t character_index) const noexcept
+	{
+		return byte_offset + (character_index - first) * character_size;
+	}
+
+	/// Get offset of one past last byte
+	size_t byte_end() const noexcept { return byte_offset_of(last); }
+};
+
+/// Range of bytes in string
+struct byte_range
+{
+	/// Offset of the first byte
+	size_t offset = 0;
+	/// Number of bytes
+	size_t size = 0;
+};
+
+/// Code units of other encodings, that offsets in string are translated to
+enum class code_unit
+{
+	/// Unicode code point
+	code_point,
+	/// UTF-16 code unit
+	utf16
+};
+
+/// Numbers of code units in UTF-8 text. 
+/// Ill-formed sequences are counted as U+FFFD
+struct code_unit_counts
+{
+	/// Number of code points
+	size_t code_points = 0;
+	/// Number of UTF-16 code units
+	size_t utf16 = 0;
+
+	/// Get number of code units of encoding
+	size_t operator[](code_unit unit) const noexcept
+	{
+		return unit == code_unit::code_point ? code_points : utf16;
+	}
+
+	/// Add code units of other text
+	code_unit_counts operator+(const code_unit_counts &other) const noexcept
+	{
+		return {code_points + other.code_points, utf16 + other.utf16};
+	}
+
+	/// Subtract code units of other text
+	code_unit_counts operator-(const code_unit_counts &other) const noexcept
+	{
+		return {code_points - other.code_points, utf16 - other.utf16};
+	}
+};
+
+/// Count code units in UTF-8 text
+code_unit_counts count_code_units(std::string_view bytes) noexcept;
+
+/// Blocks of string, without index over them.
+/// Stored as packed columns: offsets use the narrowest width, 
+/// that fits the string, and sizes of characters take a byte.
+///
+/// Block is either a run of characters of same size or a chunk.
+/// Chunk stores up to chunk_capacity characters of any size 
+/// as a base byte offset and 8-bit deltas from it.
+/// Chunks are used for characters bigger than max_character_size
+/// and for fragmented text (e.g "aбaб", emoji sequences), 
+/// where runs would hold a character or two.
+/// Outside of chunks there are at most 4 blocks per 7 characters.
+///
+/// Columns of layouts with up to inline_blocks blocks are stored inline, 
+/// so short strings and ASCII strings of any length don't allocate.
+/// Bigger columns are allocated from polymorphic memory resource, 
+/// e.g. std::pmr::monotonic_buffer_resource of a request.
+/// Copies of layout use default resource, unless resource is specified
+class layout_blocks
+{
+public:
+	/// Maximal number of blocks, that are stored inline, 
+	/// if offsets fit into 16 bits
+	static constexpr size_t inline_blocks = 
+		utility::packed_vector::inline_bytes / sizeof(uint16_t) - 1;
+	/// Number of deltas of chunks, that are stored inline
+	static constexpr size_t inline_deltas = 16;
+
+	/// Biggest character size, stored in a byte. 
+	/// Bigger characters are stored in chunks
+	static constexpr size_t max_character_size = UINT8_MAX;
+	/// Maximal number of characters in chunk
+	static constexpr size_t chunk_capacity = 64;
+	/// Blocks with fewer characters are short
+	static constexpr size_t min_block_characters = 4;
+	/// Number of consecutive short blocks, that are stored as chunks
+	static constexpr size_t min_fragmented_blocks = 4;
+
+	/// Layout of empty string
+	layout_blocks() : layout_blocks(std::pmr::get_default_resource()) {}
+
+	/// Layout of empty string, that allocates memory from resource
+	explicit layout_blocks(std::pmr::memory_resource *resource)
+		: offsets(resource), 
+		  byte_offsets(resource), 
+		  character_sizes(resource),
+		  chunk_bases(resource),
+		  chunk_starts(resource),
+		  chunk_deltas(resource)
+	{
+		offsets.push_back(0);
+		byte_offsets.push_back(0);
+	}
+
+	/// Copy layout, allocating memory from resource
+	layout_blocks(
+		const layout_blocks &other, 
+		std::pmr::memory_resource *resource
+	)
+		: offsets(other.offsets, resource),
+		  byte_offsets(other.byte_offsets, resource),
+		  character_sizes(other.character_sizes, resource),
+		  chunk_bases(other.chunk_bases, resource),
+		  chunk_starts(other.chunk_starts, resource),
+		  chunk_deltas(other.chunk_deltas, resource)
+	{}
+
+	/// Layout from runs of characters.
+	/// Offsets are followed by number of characters and bytes respectively.
+	/// Size 0 marks characters bigger than max_character_size.
+	/// Fragmented runs are stored in chunks
+	layout_blocks(
+		std::span<const size_t> offsets,
+		std::span<const size_t> byte_offsets,
+		std::span<const uint8_t> character_sizes,
+		std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+	);
+
+	/// Split string into blocks, allocated from resource.
+	/// Throws, if resource fails to allocate, e.g. std::bad_alloc
+	static layout_blocks of(
+		std::string_view bytes,
+		std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+	);
+
+	/// Split string into blocks on specified number of threads.
+	/// String is split into parts at boundaries, that don't depend 
+	/// on text before them. Blocks are same as the ones of of()
+	static layout_blocks parallel_of(
+		std::string_view bytes, 
+		size_t threads = std::thread::hardware_concurrency(),
+		std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+	);
+
+	/// Version of serialized layout format
+	static constexpr uint32_t format_version = 1;
+
+	/// Serialize layout of string. Format doesn't depend on platform
+	/// and carries checksum of string, see layout_format.cpp
+	std::vector<std::byte> serialize(std::string_view bytes) const;
+
+	/// Deserialize layout of string. Columns are copied as is.
+	/// Returns nothing, if data is corrupted, has other version 
+	/// or is a layout of other string
+	static std::optional<layout_blocks> deserialize(
+		std::span<const std::byte> data,
+		std::string_view bytes,
+		std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+	);
+
+	/// Update layout after bytes in changed range of string 
+	/// were replaced with new_length bytes.
+	/// Re-segments string from the last stable boundary before the change
+	/// until segmentation matches the old one, and shifts blocks after it.
+	/// Returns index of the first character of shifted blocks
+	size_t update(std::string_view bytes, byte_range changed, size_t new_length);
+
+	/// Get memory resource of columns
+	std::pmr::memory_resource *resource() const noexcept
+	{
+		return character_sizes.get_allocator().resource();
+	}
+
+	/// Get number of blocks
+	size_t block_count() const noexcept { return character_sizes.size(); }
+
+	/// Get number of characters
+	size_t characters() const noexcept { return offsets.back(); }
+
+	/// Get number of bytes
+	size_t bytes() const noexcept { return byte_offsets.back(); }
+
+	/// Get index of the first character of block.
+	/// Block after the last one starts at the end of string
+	size_t offset(size_t block_index) const noexcept
+	{
+		return offsets[block_index];
+	}
+
+	/// Is block a chunk of characters of different sizes?
+	bool is_chunk(size_t block_index) const noexcept
+	{
+		return character_sizes[block_index] == 0;
+	}
+
+	/// Get offset of the first byte of block.
+	/// Block after the last one starts at the end of string
+	size_t byte_offset(size_t block_index) const noexcept
+	{
+		auto offset = byte_offsets[block_index];
+		if (block_index == block_count() || !is_chunk(block_index)) 
+		{ 
+			return offset; 
+		}
+		return chunk_bases[offset];
+	}
+
+	/// Get run of characters of same size, that contains character.
+	/// Run of the block after the last one is empty and starts at the end
+	unicode::run run(size_t block_index, size_t character_index) const noexcept
+	{
+		auto first = offset(block_index);
+		if (block_index == block_count()) 
+		{ 
+			return {block_index, first, first, bytes(), 0}; 
+		}
+
+		auto byte_offset = byte_offsets[block_index];
+		auto size = character_sizes[block_index];
+		if (size != 0) 
+		{ 
+			return {
+				block_index, first, offset(block_index + 1), byte_offset, size
+			}; 
+		}
+
+		return chunk_run(block_index, character_index);
+	}
+
+	/// Get run after the given one. Run after the last one is empty
+	unicode::run next(const unicode::run &run) const noexcept
+	{
+		auto block = run.block;
+		if (!is_chunk(block) || run.last == offset(block + 1)) { ++block; }
+		return this->run(block, run.last);
+	}
+
+	/// Get run before the given one
+	unicode::run previous(const unicode::run &run) const noexcept
+	{
+		assert(run.first != 0 && "there is no run before the first one");
+		auto block = run.block;
+		if (run.first == offset(block)) { --block; }
+		return this->run(block, run.first - 1);
+	}
+
+	/// Are blocks equal?
+	bool operator==(const layout_blocks &other) const = default;
+
+	/// Get number of bytes, allocated for blocks. 
+	/// Inline columns aren't counted
+	size_t memory_usage() const noexcept
+	{
+		return 
+			offsets.memory_usage() + 
+			byte_offsets.memory_usage() + 
+			character_sizes.memory_usage() +
+			chunk_bases.memory_usage() +
+			chunk_starts.memory_usage() +
+			chunk_deltas.memory_usage();
+	}
+
+	/// Get run of a single character, that contains byte
+	unicode::run character_at_byte(size_t byte_offset) const noexcept;
+
+protected:
+	/// Get run of a single character inside of chunk
+	unicode::run chunk_run(
+		size_t block_index, 
+		size_t character_index
+	) const noexcept;
+
+	/// Do columns describe blocks, that cover string of specified size?
+	/// Checked on deserialization, so blocks may be indexed without checks
+	bool is_consistent(size_t bytes) const noexcept;
+
+	/// Character offsets of blocks, followed by number of characters
+	utility::packed_vector offsets;
+	/// Byte offsets of runs or indexes of chunks, 
+	/// followed by number of bytes
+	utility::packed_vector byte_offsets;
+	/// Sizes of characters in runs. 0 for chunks
+	utility::small_vector<uint8_t, inline_blocks + 1> character_sizes;
+	/// Byte offsets of chunks
+	utility::packed_vector chunk_bases;
+	/// Indexes of the first delta of chunks
+	utility::packed_vector chunk_starts;
+	/// Byte offsets of characters inside of chunks, relative to base
+	utility::small_vector<uint8_t, inline_deltas> chunk_deltas;
 };
 
 /// Unicode string layout
-struct layout
+/// @tparam Index policy for searching blocks, see unicode::offset_index
+template<typename Index = offset_index::binary_search>
+class basic_layout : public layout_blocks
 {
-	/// Character offsets of blocks
-	utility::sorted_vector<size_t> offsets;
-	/// Blocks of consecutive characters with same size
-	std::vector<block> blocks;
+public:
+	using index_type = Index;
 
-	/// Get layout of string
-	static layout of(std::string_view bytes) noexcept;
+	/// Layout of empty string
+	basic_layout() { build_index(); }
 
-	/// Get index of block for specified character
+	/// Index blocks of string. Index uses memory resource of blocks
+	explicit basic_layout(layout_blocks blocks) 
+		: layout_blocks(std::move(blocks)), index(this->resource())
+	{ 
+		build_index(); 
+	}
+
+	/// Copy layout, allocating blocks and index from resource
+	basic_layout(const basic_layout &other, std::pmr::memory_resource *resource)
+		: layout_blocks(other, resource), index(resource)
+	{ 
+		build_index(); 
+	}
+
+	/// Get layout of string, allocated from resource
+	static basic_layout of(
+		std::string_view bytes,
+		std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+	)
+	{
+		return basic_layout(layout_blocks::of(bytes, resource));
+	}
+
+	/// Get layout of string, built on specified number of threads
+	static basic_layout parallel_of(
+		std::string_view bytes, 
+		size_t threads = std::thread::hardware_concurrency(),
+		std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+	)
+	{
+		return basic_layout(layout_blocks::parallel_of(bytes, threads, resource));
+	}
+
+	/// Deserialize layout of string and index it.
+	/// Returns nothing, if data is not a valid layout of string
+	static std::optional<basic_layout> deserialize(
+		std::span<const std::byte> data,
+		std::string_view bytes,
+		std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+	)
+	{
+		auto blocks = layout_blocks::deserialize(data, bytes, resource);
+		if (!blocks) { return std::nullopt; }
+		return basic_layout(std::move(*blocks));
+	}
+
+	/// Rebuild layout after change in string, keeping memory resource
+	void update(std::string_view bytes) { *this = of(bytes, resource()); }
+
+	/// Update layout after bytes in changed range of string 
+	/// were replaced with new_length bytes.
+	/// Returns index of the first character of shifted blocks
+	size_t update(std::string_view bytes, byte_range changed, size_t new_length)
+	{
+		auto shifted = layout_blocks::update(bytes, changed, new_length);
+		build_index();
+		return shifted;
+	}
+
+	/// Get index of block for specified character.
+	/// One past last character belongs to the block after last
 	size_t block_index_for_character(size_t character_index) const noexcept
 	{
-		auto next = offsets.upper_bound(character_index);
-		assert(next != offsets.begin() && "block not found");
-		return std::distance(offsets.begin(), next) - 1;
+		assert(character_index <= characters() && "out of range");
+		return offsets.visit(
+			[&](auto offsets) { return index.find(offsets, character_index); }
+		);
+	}
+
+	/// Get number of bytes, used by layout
+	size_t memory_usage() const noexcept
+	{
+		return layout_blocks::memory_usage() + index.memory_usage();
+	}
+
+protected:
+	/// Index over offsets of blocks
+	Index index;
+
+	/// Rebuild index after change of blocks
+	void build_index()
+	{
+		offsets.visit([&](auto offsets) { index.build(offsets); });
+	}
+};
+
+/// Layout with binary search over blocks
+using layout = basic_layout<>;
+
+/// Does layout access characters without throwing?
+/// Layouts, that segment string on demand, e.g. unicode::lazy_layout, 
+/// may allocate on access
+template<typename Layout>
+constexpr bool is_nothrow_accessible = 
+	noexcept(std::declval<const Layout &>().characters()) &&
+	noexcept(std::declval<const Layout &>().block_index_for_character(0)) &&
+	noexcept(std::declval<const Layout &>().next(unicode::run{}));
+
+/// Reference to layout, owned by another object, e.g. unicode::string.
+/// Copying reference doesn't copy layout
+template<typename Layout>
+class layout_reference
+{
+public:
+	using layout_type = Layout;
+
+	/// Reference to layout of empty string
+	layout_reference() : layout(&empty) {}
+
+	/// Reference to layout
+	explicit layout_reference(const Layout &layout) noexcept 
+		: layout(&layout) {}
+
+	/// Get referenced layout
+	const Layout &get() const noexcept { return *layout; }
+
+	/// Get number of blocks
+	size_t block_count() const noexcept(is_nothrow_accessible<Layout>) 
+	{ 
+		return layout->block_count(); 
+	}
+
+	/// Get number of characters
+	size_t characters() const noexcept(is_nothrow_accessible<Layout>) 
+	{ 
+		return layout->characters(); 
+	}
+
+	/// Get number of bytes
+	size_t bytes() const noexcept { return layout->bytes(); }
+
+	/// Get index of block for specified character
+	size_t block_index_for_character(size_t character_index) const 
+		noexcept(is_nothrow_accessible<Layout>)
+	{
+		return layout->block_index_for_character(character_index);
+	}
+
+	/// Get run of characters of same size, that contains character
+	unicode::run run(size_t block_index, size_t character_index) const noexcept
+	{
+		return layout->run(block_index, character_index);
 	}
+
+	/// Get run after the given one
+	unicode::run next(const unicode::run &run) const 
+		noexcept(is_nothrow_accessible<Layout>)
+	{
+		return layout->next(run);
+	}
+
+	/// Get run before the given one
+	unicode::run previous(const unicode::run &run) const noexcept
+	{
+		return layout->previous(run);
+	}
+
+	/// Get run of a single character, that contains byte
+	unicode::run character_at_byte(size_t byte_offset) const noexcept
+	{
+		return layout->character_at_byte(byte_offset);
+	}
+
+	/// Get number of code units before character
+	size_t units_before(
+		std::string_view bytes, 
+		size_t character_index, 
+		code_unit unit
+	) const noexcept
+	{
+		return layout->units_before(bytes, character_index, unit);
+	}
+
+	/// Get index of character, that contains code unit
+	size_t character_of_unit(
+		std::string_view bytes, 
+		size_t unit_offset, 
+		code_unit unit
+	) const noexcept
+	{
+		return layout->character_of_unit(bytes, unit_offset, unit);
+	}
+
+	/// Get number of bytes, used by layout. Referenced layout isn't counted
+	size_t memory_usage() const noexcept { return 0; }
+
+private:
+	/// Layout of empty string
+	static inline const Layout empty;
+	/// Referenced layout
+	const Layout *layout;
 };
 	
 } // namespace unicode
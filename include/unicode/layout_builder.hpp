@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "unicode/layout.hpp"
+
+namespace unicode
+{
+
+namespace utility
+{
+class thread_pool;
+} // namespace utility
+
+/// Builder of layouts for batches of strings, e.g. rows of a database column.
+/// Segmentation buffers and worker threads are reused between strings
+/// and batches, and layouts are allocated from arenas of builder.
+/// Layouts must not outlive builder or the next call to reset()
+class layout_builder
+{
+public:
+	/// Builder, that segments batches on specified number of threads,
+	/// including the calling one.
+	/// Arenas get memory from upstream resource in blocks
+	explicit layout_builder(
+		size_t threads = 1,
+		std::pmr::memory_resource *upstream = std::pmr::get_default_resource()
+	);
+
+	layout_builder(const layout_builder &) = delete;
+	layout_builder &operator=(const layout_builder &) = delete;
+
+	/// Stop worker threads
+	~layout_builder();
+
+	/// Build layouts of strings in the same order
+	std::vector<layout> build(std::span<const std::string_view> strings);
+
+	/// Free memory of all built layouts at once
+	void reset() noexcept;
+
+	/// Get number of threads, used by builder
+	size_t threads() const noexcept;
+
+private:
+	/// Source of memory for arenas
+	std::pmr::memory_resource *upstream;
+	/// Arena of each part of batch. Parts are built on different threads
+	std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>> arenas;
+	/// Worker threads. Missing for a single thread
+	std::unique_ptr<utility::thread_pool> pool;
+
+	/// Get arena of part of batch
+	std::pmr::memory_resource *arena(size_t part);
+};
+
+} // namespace unicode
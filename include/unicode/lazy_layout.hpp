@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <string_view>
+
+#include "unicode/layout.hpp"
+#include "unicode/utility/packed_vector.hpp"
+
+namespace unicode
+{
+
+/// Layout, that is built on demand.
+/// Construction only remembers the string. Runs of characters are
+/// segmented in growing steps, just far enough for the biggest index
+/// requested so far. Number of characters is known only when the whole
+/// string is segmented, so characters() completes the layout.
+/// Columns are packed, like columns of unicode::layout_blocks.
+/// Layout is mutated by const methods, so it's not thread safe
+/// and methods, that segment the string, may throw std::bad_alloc
+class lazy_layout
+{
+public:
+	/// Number of bytes, segmented by the first step.
+	/// Each next step is twice as big
+	static constexpr size_t first_step = 4096;
+
+	/// Layout of empty string
+	lazy_layout()
+	{
+		offsets.push_back(0);
+		byte_offsets.push_back(0);
+	}
+
+	/// Get layout of string without segmenting it
+	static lazy_layout of(std::string_view bytes) noexcept
+	{
+		lazy_layout layout;
+		layout.text = bytes;
+		return layout;
+	}
+
+	/// Forget layout after change in string
+	void update(std::string_view bytes) { *this = of(bytes); }
+
+	/// Update layout after bytes in changed range of string 
+	/// were replaced with new_length bytes.
+	/// Forgets runs, that may depend on changed bytes
+	void update(std::string_view bytes, byte_range changed, size_t new_length);
+
+	/// Is the whole string segmented?
+	bool is_complete() const noexcept 
+	{ 
+		return byte_offsets.back() == text.size(); 
+	}
+
+	/// Segment the whole string
+	void complete() const 
+	{ 
+		while (!is_complete()) { extend(); } 
+	}
+
+	/// Get number of segmented characters
+	size_t segmented_characters() const noexcept { return offsets.back(); }
+
+	/// Get number of blocks. Completes layout
+	size_t block_count() const 
+	{ 
+		complete();
+		return character_sizes.size(); 
+	}
+
+	/// Get number of characters. Completes layout
+	size_t characters() const 
+	{ 
+		complete();
+		return offsets.back(); 
+	}
+
+	/// Get number of bytes
+	size_t bytes() const noexcept { return text.size(); }
+
+	/// Get index of block for specified character, segmenting up to it.
+	/// One past last character belongs to the block after last
+	size_t block_index_for_character(size_t character_index) const
+	{
+		while (character_index >= offsets.back() && !is_complete()) 
+		{ 
+			extend(); 
+		}
+		auto next = offsets.visit([character_index](auto values)
+		{
+			return size_t(
+				std::upper_bound(values.begin(), values.end(), character_index) - 
+				values.begin()
+			);
+		});
+		return std::min(next - 1, character_sizes.size());
+	}
+
+	/// Get run of characters of same size, that contains character.
+	/// Run of the block after the last one is empty and starts at the end
+	unicode::run run(size_t block_index, size_t) const noexcept
+	{
+		auto first = offsets[block_index];
+		if (block_index == character_sizes.size()) 
+		{ 
+			assert(is_complete() && "block is not segmented yet");
+			return {block_index, first, first, bytes(), 0}; 
+		}
+		return {
+			block_index, 
+			first, 
+			offsets[block_index + 1], 
+			byte_offsets[block_index], 
+			character_sizes[block_index]
+		};
+	}
+
+	/// Get run after the given one, segmenting it if needed.
+	/// Run after the last one is empty
+	unicode::run next(const unicode::run &run) const
+	{
+		auto block = run.block + 1;
+		if (block == character_sizes.size() && !is_complete()) { extend(); }
+		return this->run(block, run.last);
+	}
+
+	/// Get run before the given one
+	unicode::run previous(const unicode::run &run) const noexcept
+	{
+		assert(run.first != 0 && "there is no run before the first one");
+		return this->run(run.block - 1, run.first - 1);
+	}
+
+	/// Get number of bytes, allocated for segmented runs
+	size_t memory_usage() const noexcept
+	{
+		return 
+			offsets.memory_usage() + 
+			byte_offsets.memory_usage() + 
+			character_sizes.memory_usage();
+	}
+
+private:
+	/// Segmented string
+	std::string_view text;
+	/// Character offsets of runs, followed by number of segmented characters
+	mutable utility::packed_vector offsets;
+	/// Byte offsets of runs, followed by number of segmented bytes
+	mutable utility::packed_vector byte_offsets;
+	/// Sizes of characters in runs
+	mutable utility::packed_vector character_sizes;
+	/// Number of bytes to segment by the next step
+	mutable size_t step = first_step;
+
+	/// Segment at least one more character
+	void extend() const;
+};
+
+} // namespace unicode
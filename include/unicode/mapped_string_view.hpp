@@ -0,0 +1,95 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+#include <utility>
+
+#include "unicode/string_view.hpp"
+
+namespace unicode
+{
+
+/// View over unicode characters of read-only memory-mapped UTF-8 file.
+/// Layout is loaded from sidecar file next to it (see layout_format.cpp),
+/// which is built, if it's missing or stale.
+/// Text stays mapped and isn't copied, so it may be larger than RAM.
+/// Layout is read from sidecar into memory, so it isn't zero-copy:
+/// loading costs a pass over sidecar and memory for the layout
+/// Available on POSIX systems
+class mapped_string_view
+{
+public:
+	/// Suffix of sidecar file with layout
+	static constexpr std::string_view sidecar_extension = ".layout";
+
+	/// Get path of sidecar file with layout of file
+	static std::filesystem::path sidecar_path(const std::filesystem::path &path)
+	{
+		auto sidecar = path;
+		sidecar += sidecar_extension;
+		return sidecar;
+	}
+
+	/// Map file and load its layout from sidecar into memory.
+	/// Throws std::system_error, if file can't be mapped
+	explicit mapped_string_view(const std::filesystem::path &path);
+
+	mapped_string_view(const mapped_string_view &) = delete;
+	mapped_string_view &operator=(const mapped_string_view &) = delete;
+
+	/// Take mapping of other view
+	mapped_string_view(mapped_string_view &&other) noexcept
+		: text(std::exchange(other.text, {})),
+		  characters(std::exchange(other.characters, {})),
+		  loaded(other.loaded)
+	{}
+	/// Take mapping of other view
+	mapped_string_view &operator=(mapped_string_view &&other) noexcept
+	{
+		std::swap(text, other.text);
+		std::swap(characters, other.characters);
+		std::swap(loaded, other.loaded);
+		return *this;
+	}
+
+	/// Unmap file
+	~mapped_string_view();
+
+	/// Get view over characters of file
+	const string_view &view() const noexcept { return characters; }
+	/// Get view over characters of file
+	operator const string_view &() const noexcept { return characters; }
+	/// Get bytes of file
+	operator std::string_view() const noexcept { return text; }
+
+	/// Was layout loaded from sidecar file?
+	bool layout_loaded() const noexcept { return loaded; }
+
+	/// Get iterator for first character
+	string_view::iterator begin() const noexcept { return characters.begin(); }
+	/// Get iterator for one past last character
+	string_view::iterator end() const noexcept { return characters.end(); }
+
+	/// Get size of file in characters
+	size_t size() const noexcept { return characters.size(); }
+
+	/// Is file empty?
+	[[nodiscard]]
+	bool empty() const noexcept { return characters.empty(); }
+
+	/// Get character by index
+	character_view operator[](size_t index) const noexcept
+	{
+		return characters[index];
+	}
+
+private:
+	/// Mapped bytes of file
+	std::string_view text;
+	/// View over mapped bytes
+	string_view characters;
+	/// Was layout loaded from sidecar file?
+	bool loaded = false;
+};
+
+} // namespace unicode
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define UNICODE_BTREE_AVX2 1
+#define UNICODE_BTREE_AVX2_TARGET
+#elif \
+	(defined(__GNUC__) || defined(__clang__)) && \
+	(defined(__x86_64__) || defined(__i386__))
+// AVX2 is used on CPUs, that support it, even if compiler doesn't target it
+#include <immintrin.h>
+#define UNICODE_BTREE_AVX2 1
+#define UNICODE_BTREE_AVX2_DISPATCH 1
+#define UNICODE_BTREE_AVX2_TARGET [[gnu::target("avx2")]]
+#endif
+
+/// Policies for searching block by character index in layout.
+/// Each policy is built over sorted offsets of blocks
+/// and finds index of the last offset, that is not greater than value
+namespace unicode::offset_index
+{
+
+/// Binary search over offsets themselves. Needs no extra memory
+struct binary_search
+{
+	/// Empty index
+	binary_search() = default;
+	/// Empty index, that would allocate memory from resource
+	explicit binary_search(std::pmr::memory_resource *) noexcept {}
+
+	/// Build index over sorted offsets
+	template<typename Offsets>
+	void build(const Offsets &) noexcept {}
+
+	/// Find index of the last offset, that is not greater than value
+	template<typename Offsets>
+	size_t find(const Offsets &offsets, size_t value) const noexcept
+	{
+		auto first = std::begin(offsets);
+		auto next = std::upper_bound(first, std::end(offsets), value);
+		assert(next != first && "offset not found");
+		return std::distance(first, next) - 1;
+	}
+
+	/// Get number of bytes, used by index
+	size_t memory_usage() const noexcept { return 0; }
+};
+
+/// Static B+-tree over offsets.
+/// Offsets themselves are the leaves,
+/// each upper level holds the first key of every node of the level below.
+/// Node is a cache line, so search touches one line per level.
+/// Keys of node are compared with AVX2, if compiler targets it,
+/// or if CPU supports it on x86 with GCC and Clang
+class btree
+{
+public:
+	/// Number of keys in node
+	static constexpr size_t node_size = 8;
+
+	/// Empty index
+	btree() = default;
+	/// Empty index, that allocates memory from resource
+	explicit btree(std::pmr::memory_resource *resource) 
+		: nodes(resource), levels(resource) {}
+
+	/// Build index over sorted offsets
+	template<typename Offsets>
+	void build(const Offsets &offsets)
+	{
+		nodes.clear();
+		levels.clear();
+
+		// Key i of upper level holds offset i * stride, 
+		// where stride grows node_size times with each level
+		size_t size = std::size(offsets);
+		size_t depth = 0;
+		size_t stride = 1;
+		size_t node_count = 0;
+		for (auto keys = size; keys > node_size; ++depth)
+		{
+			keys = (keys + node_size - 1) / node_size;
+			stride *= node_size;
+			node_count += (keys + node_size - 1) / node_size;
+		}
+		nodes.reserve(node_count);
+		levels.reserve(depth);
+
+		// Levels are stored top-down
+		for (; depth != 0; --depth, stride /= node_size)
+		{
+			levels.push_back(nodes.size());
+			auto keys = (size + stride - 1) / stride;
+			for (size_t i = 0; i < keys; i += node_size)
+			{
+				// Padding is greater than any character index
+				node node;
+				node.keys.fill(padding);
+				for (size_t j = 0; j < node_size && i + j < keys; ++j)
+				{
+					node.keys[j] = offsets[(i + j) * stride];
+				}
+				nodes.push_back(node);
+			}
+		}
+	}
+
+	/// Find index of the last offset, that is not greater than value
+	template<typename Offsets>
+	size_t find(const Offsets &offsets, size_t value) const noexcept
+	{
+		assert(value < padding && "value is too big");
+
+#if defined(UNICODE_BTREE_AVX2_DISPATCH)
+		auto index = has_avx2 ? find_node_avx2(value) : find_node(value);
+#else
+		auto index = find_node(value);
+#endif
+		auto first = index * node_size;
+		auto last = std::min(first + node_size, size_t(std::size(offsets)));
+		size_t count = 0;
+		for (auto i = first; i < last; ++i)
+		{
+			count += size_t(offsets[i]) <= value;
+		}
+		assert(count != 0 && "offset not found");
+		return first + count - 1;
+	}
+
+	/// Get number of bytes, used by index
+	size_t memory_usage() const noexcept
+	{
+		return
+			nodes.capacity() * sizeof(node) +
+			levels.capacity() * sizeof(size_t);
+	}
+
+	/// Get name of instructions, that compare keys of node
+	static const char *node_compare() noexcept
+	{
+#if defined(__AVX2__)
+		return "AVX2";
+#elif defined(UNICODE_BTREE_AVX2_DISPATCH)
+		return has_avx2 ? "AVX2, dispatched" : "scalar";
+#else
+		return "scalar";
+#endif
+	}
+
+private:
+	/// Key, that is greater than any character index.
+	/// Fits into signed integer for SIMD comparison
+	static constexpr size_t padding = std::numeric_limits<ptrdiff_t>::max();
+
+	/// Node of tree
+	struct alignas(64) node
+	{
+		/// Sorted keys, padded at the end
+		std::array<size_t, node_size> keys;
+	};
+
+	/// Find index of leaf node, that contains value
+	size_t find_node(size_t value) const noexcept
+	{
+		// Index of node in current level
+		size_t index = 0;
+		for (auto start : levels)
+		{
+			index =
+				index * node_size +
+				count_not_greater(nodes[start + index], value) - 1;
+		}
+		return index;
+	}
+
+	/// Count keys in node, that are not greater than value
+	static size_t count_not_greater(const node &node, size_t value) noexcept
+	{
+#if defined(__AVX2__)
+		return count_not_greater_avx2(node, value);
+#else
+		size_t count = 0;
+		for (auto key : node.keys) { count += key <= value; }
+		return count;
+#endif
+	}
+
+#if defined(UNICODE_BTREE_AVX2_DISPATCH)
+	/// Does CPU support AVX2? Checked once, when program starts
+	static inline const bool has_avx2 = []
+	{
+		// CPU features may be not detected yet by other static initializers
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") != 0;
+	}();
+
+	/// Find index of leaf node, that contains value, comparing keys with AVX2
+	UNICODE_BTREE_AVX2_TARGET
+	size_t find_node_avx2(size_t value) const noexcept
+	{
+		size_t index = 0;
+		for (auto start : levels)
+		{
+			index =
+				index * node_size +
+				count_not_greater_avx2(nodes[start + index], value) - 1;
+		}
+		return index;
+	}
+#endif
+
+#if defined(UNICODE_BTREE_AVX2)
+	/// Count keys in node, that are not greater than value, with AVX2
+	UNICODE_BTREE_AVX2_TARGET
+	static size_t count_not_greater_avx2(const node &node, size_t value) noexcept
+	{
+		auto target = _mm256_set1_epi64x(int64_t(value));
+		auto low = _mm256_load_si256(
+			reinterpret_cast<const __m256i *>(node.keys.data())
+		);
+		auto high = _mm256_load_si256(
+			reinterpret_cast<const __m256i *>(node.keys.data() + 4)
+		);
+		uint32_t greater =
+			_mm256_movemask_pd(
+				_mm256_castsi256_pd(_mm256_cmpgt_epi64(low, target))
+			) |
+			(_mm256_movemask_pd(
+				_mm256_castsi256_pd(_mm256_cmpgt_epi64(high, target))
+			) << 4);
+		return node_size - std::popcount(greater);
+	}
+#endif
+
+	/// Nodes of upper levels, from root to the level above leaves
+	std::pmr::vector<node> nodes;
+	/// Index of the first node of each level
+	std::pmr::vector<size_t> levels;
+};
+
+} // namespace unicode::offset_index
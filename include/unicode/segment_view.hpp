@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string_view>
+
+#include "unicode/layout.hpp"
+#include "unicode/string_view.hpp"
+
+namespace unicode
+{
+
+/// Kinds of text segments, other than characters
+enum class segment
+{
+	/// Words, spaces and punctuation between them (UAX #29)
+	word,
+	/// Sentences with trailing spaces (UAX #29)
+	sentence,
+	/// Text between line break opportunities (UAX #14)
+	line
+};
+
+/// Split string into blocks of segments, found by ICU break iterator 
+/// for default locale. Segments are stored like characters:
+/// segments of same size form runs, fragmented ones go to chunks
+/// and segments bigger than max_character_size are stored separately
+layout_blocks segments_of(std::string_view bytes, segment kind);
+
+/// Layout of words, sentences or line break opportunities.
+/// Layout is rebuilt after changes in string
+/// @tparam Kind kind of segments
+/// @tparam Index policy for searching blocks, see unicode::offset_index
+template<segment Kind, typename Index = offset_index::binary_search>
+class segment_layout : public basic_layout<Index>
+{
+public:
+	/// Layout of empty string
+	segment_layout() = default;
+
+	/// Index blocks of segments
+	explicit segment_layout(layout_blocks blocks) 
+		: basic_layout<Index>(std::move(blocks)) {}
+
+	/// Get layout of string
+	static segment_layout of(std::string_view bytes)
+	{
+		return segment_layout(segments_of(bytes, Kind));
+	}
+
+	/// Rebuild layout after change in string
+	void update(std::string_view bytes) { *this = of(bytes); }
+
+	/// Rebuild layout after bytes in changed range of string 
+	/// were replaced with new_length bytes
+	void update(std::string_view bytes, byte_range, size_t) { update(bytes); }
+};
+
+/// View over words of string
+using word_view = basic_string_view<segment_layout<segment::word>>;
+/// View over sentences of string
+using sentence_view = basic_string_view<segment_layout<segment::sentence>>;
+/// View over pieces of string between line break opportunities
+using line_break_view = basic_string_view<segment_layout<segment::line>>;
+
+} // namespace unicode
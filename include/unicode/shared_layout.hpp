@@ -0,0 +1,551 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "unicode/layout.hpp"
+
+namespace unicode
+{
+
+/// Window over layout, that is shared by copies and slices of it.
+/// Copying and slicing are O(1) and don't segment string again.
+/// Shared layout is immutable: updates copy it, unless it isn't shared.
+/// Layouts of up to inline_runs runs, that allocate no memory,
+/// e.g. ones of short strings and ASCII strings of any length,
+/// are encoded inline as runs instead, in place of the window,
+/// so they don't allocate and views stay small
+/// @tparam Layout layout of the whole string, e.g. unicode::basic_layout
+template<typename Layout>
+class shared_layout
+{
+public:
+	using layout_type = Layout;
+
+	/// Maximal number of runs of layout, that is encoded inline
+	static constexpr size_t inline_runs = 6;
+
+	/// Does layout allocate memory from memory resource?
+	static constexpr bool has_resource =
+		requires (const Layout &layout) { layout.resource(); };
+
+	/// Layout of empty string
+	shared_layout() : shared_layout(Layout()) {}
+
+	/// Share layout of string or encode it inline.
+	/// Shared state is allocated from memory resource of layout, if it has one
+	explicit shared_layout(Layout layout)
+	{
+		if (auto encoded = compact::encode(layout)) { local = *encoded; }
+		else { *this = shared_layout(share(std::move(layout))); }
+	}
+
+	/// Get layout of string
+	static shared_layout of(std::string_view bytes)
+	{
+		return shared_layout(Layout::of(bytes));
+	}
+
+	/// Get layout of string, allocated from resource
+	static shared_layout of(
+		std::string_view bytes,
+		std::pmr::memory_resource *resource
+	)
+	{
+		return shared_layout(Layout::of(bytes, resource));
+	}
+
+	/// Rebuild layout after change in string, keeping memory resource
+	void update(std::string_view bytes)
+	{
+		if constexpr (has_resource) { *this = of(bytes, resource()); }
+		else { *this = of(bytes); }
+	}
+
+	/// Update layout after bytes in changed range of string
+	/// were replaced with new_length bytes.
+	/// Layout is copied, if it's shared. Slices are rebuilt,
+	/// and so are inline layouts, that can't be decoded
+	void update(std::string_view bytes, byte_range changed, size_t new_length)
+	{
+		if (!is_whole()) { return update(bytes); }
+
+		if (!layout)
+		{
+			if constexpr (std::is_constructible_v<Layout, layout_blocks>)
+			{
+				auto decoded = local.decode();
+				decoded.update(bytes, changed, new_length);
+				*this = shared_layout(std::move(decoded));
+			}
+			else { update(bytes); }
+			return;
+		}
+
+		if (layout.use_count() != 1) { layout = share(copy(*layout)); }
+		layout->update(bytes, changed, new_length);
+		*this = shared_layout(std::move(layout));
+	}
+
+	/// Get layout of characters in range [first, last) of this one
+	shared_layout slice(size_t first, size_t last) const noexcept
+	{
+		assert(first <= last && last <= characters() && "wrong range");
+		if (!layout) { return shared_layout(local.slice(first, last)); }
+		return shared_layout(
+			layout,
+			frame.first + first,
+			frame.first + last
+		);
+	}
+
+	/// Is layout shared? Layouts, encoded inline, aren't
+	bool is_shared() const noexcept { return bool(layout); }
+
+	/// Get shared layout of the whole string
+	const Layout &get() const noexcept
+	{
+		assert(is_shared() && "layout is encoded inline");
+		return *layout;
+	}
+
+	/// Get memory resource of layout
+	std::pmr::memory_resource *resource() const noexcept
+		requires has_resource
+	{
+		return layout ? layout->resource() : local.resource;
+	}
+
+	/// Is it a layout of the whole string?
+	bool is_whole() const noexcept { return whole; }
+
+	/// Get number of blocks, that intersect window
+	size_t block_count() const noexcept
+	{
+		return layout ? frame.blocks : local.runs;
+	}
+
+	/// Get number of characters
+	size_t characters() const noexcept
+	{
+		return layout ? frame.last - frame.first : local.characters();
+	}
+
+	/// Get number of bytes
+	size_t bytes() const noexcept
+	{
+		return layout ? frame.byte_last - frame.byte_first : local.bytes();
+	}
+
+	/// Get index of block for specified character.
+	/// One past last character belongs to the block after last
+	size_t block_index_for_character(size_t character_index) const noexcept
+	{
+		assert(character_index <= characters() && "out of range");
+		if (!layout) { return local.block_of(character_index); }
+		if (character_index == characters()) { return frame.blocks; }
+		return
+			layout->block_index_for_character(frame.first + character_index) -
+			frame.first_block;
+	}
+
+	/// Get run of characters of same size, that contains character.
+	/// Run of the block after the last one is empty and starts at the end
+	unicode::run run(size_t block_index, size_t character_index) const noexcept
+	{
+		if (!layout) { return local.run(block_index); }
+		if (whole) [[likely]] { return layout->run(block_index, character_index); }
+		if (block_index == frame.blocks)
+		{
+			return {frame.blocks, character_index, character_index, bytes(), 0};
+		}
+		return clip(
+			layout->run(
+				frame.first_block + block_index,
+				frame.first + character_index
+			)
+		);
+	}
+
+	/// Get run after the given one. Run after the last one is empty
+	unicode::run next(const unicode::run &run) const noexcept
+	{
+		if (!layout) { return local.run(run.block + 1); }
+		if (whole) [[likely]] { return layout->next(run); }
+		return next_in_window(run);
+	}
+
+	/// Get run before the given one
+	unicode::run previous(const unicode::run &run) const noexcept
+	{
+		assert(run.first != 0 && "there is no run before the first one");
+		if (!layout) { return local.run(run.block - 1); }
+		if (whole) [[likely]] { return layout->previous(run); }
+		if (run.block == frame.blocks)
+		{
+			return this->run(frame.blocks - 1, run.first - 1);
+		}
+		return clip(layout->previous(unclip(run)));
+	}
+
+	/// Get run of a single character, that contains byte
+	unicode::run character_at_byte(size_t byte_offset) const noexcept
+	{
+		if (!layout) { return local.character_at_byte(byte_offset); }
+		return clip(layout->character_at_byte(frame.byte_first + byte_offset));
+	}
+
+	/// Get number of code units before character.
+	/// Code units of inline layouts are counted in bytes.
+	/// Layout must have translation columns, e.g. unicode::translation_layout
+	size_t units_before(
+		std::string_view bytes,
+		size_t character_index,
+		code_unit unit
+	) const noexcept
+	{
+		if (!layout)
+		{
+			auto prefix = bytes.substr(0, local.byte_offset_of(character_index));
+			return count_code_units(prefix)[unit];
+		}
+
+		auto string = whole_string(bytes);
+		auto first = frame.first;
+		auto units = layout->units_before(string, first + character_index, unit);
+		if (whole) [[likely]] { return units; }
+		return units - layout->units_before(string, first, unit);
+	}
+
+	/// Get index of character, that contains code unit.
+	/// Offset of the end of window maps to number of characters.
+	/// Layout must have translation columns, e.g. unicode::translation_layout
+	size_t character_of_unit(
+		std::string_view bytes,
+		size_t unit_offset,
+		code_unit unit
+	) const noexcept
+	{
+		if (!layout) { return local.character_of_unit(bytes, unit_offset, unit); }
+
+		auto string = whole_string(bytes);
+		if (whole) [[likely]]
+		{
+			return layout->character_of_unit(string, unit_offset, unit);
+		}
+		auto base = layout->units_before(string, frame.first, unit);
+		auto index = layout->character_of_unit(string, base + unit_offset, unit);
+		return std::min(index, frame.last) - frame.first;
+	}
+
+	/// Get number of bytes, used by shared layout of the whole string.
+	/// Inline layouts use none
+	size_t memory_usage() const noexcept
+	{
+		return layout ? layout->memory_usage() : 0;
+	}
+
+private:
+	/// Window over characters of shared layout
+	struct window
+	{
+		/// Index of the first character
+		size_t first = 0;
+		/// Index of one past last character
+		size_t last = 0;
+		/// Offset of the first byte
+		size_t byte_first = 0;
+		/// Offset of one past last byte
+		size_t byte_last = 0;
+		/// Index of block, that contains the first character
+		size_t first_block = 0;
+		/// Number of blocks, that intersect window
+		size_t blocks = 0;
+	};
+
+	/// Layout of few runs, encoded inline.
+	/// Runs are looked up by linear search
+	struct compact
+	{
+		/// Memory resource, that layout is decoded with
+		std::pmr::memory_resource *resource = std::pmr::get_default_resource();
+		/// Index of one past last character of each run
+		std::array<uint32_t, inline_runs> ends{};
+		/// Size of characters of each run
+		std::array<uint8_t, inline_runs> sizes{};
+		/// Number of runs
+		uint8_t runs = 0;
+
+		/// Encode runs of layout, if it allocates no memory and has few runs
+		static std::optional<compact> encode(const Layout &layout) noexcept
+		{
+			if (
+				layout.memory_usage() != 0 ||
+				layout.bytes() > std::numeric_limits<uint32_t>::max()
+			)
+			{
+				return std::nullopt;
+			}
+
+			compact encoded;
+			if constexpr (has_resource) { encoded.resource = layout.resource(); }
+			for (
+				auto run = layout.run(0, 0);
+				run.first != run.last;
+				run = layout.next(run)
+			)
+			{
+				// Runs of chunks are merged, if their characters have same size
+				auto size = run.character_size;
+				if (encoded.runs != 0 && encoded.sizes[encoded.runs - 1] == size)
+				{
+					encoded.ends[encoded.runs - 1] = uint32_t(run.last);
+					continue;
+				}
+				if (
+					encoded.runs == inline_runs ||
+					size > std::numeric_limits<uint8_t>::max()
+				)
+				{
+					return std::nullopt;
+				}
+				encoded.ends[encoded.runs] = uint32_t(run.last);
+				encoded.sizes[encoded.runs] = uint8_t(size);
+				++encoded.runs;
+			}
+			return encoded;
+		}
+
+		/// Get layout of runs
+		Layout decode() const
+		{
+			std::array<size_t, inline_runs + 1> offsets{}, byte_offsets{};
+			for (size_t i = 0; i < runs; ++i)
+			{
+				offsets[i + 1] = ends[i];
+				byte_offsets[i + 1] = run(i).byte_end();
+			}
+			return Layout(
+				layout_blocks(
+					std::span(offsets).first(runs + 1u),
+					std::span(byte_offsets).first(runs + 1u),
+					std::span(sizes).first(runs),
+					resource
+				)
+			);
+		}
+
+		/// Get encoding of characters in range [first, last)
+		compact slice(size_t first, size_t last) const noexcept
+		{
+			compact sliced;
+			sliced.resource = resource;
+			for (size_t i = block_of(first); i < runs && first < last; ++i)
+			{
+				auto end = std::min<size_t>(ends[i], last);
+				sliced.ends[sliced.runs] = uint32_t(end - first) +
+					(sliced.runs == 0 ? 0 : sliced.ends[sliced.runs - 1]);
+				sliced.sizes[sliced.runs] = sizes[i];
+				++sliced.runs;
+				first = end;
+			}
+			return sliced;
+		}
+
+		/// Get number of characters
+		size_t characters() const noexcept
+		{
+			return runs == 0 ? 0 : ends[runs - 1];
+		}
+
+		/// Get number of bytes
+		size_t bytes() const noexcept { return run(runs).byte_offset; }
+
+		/// Get index of run, that contains character.
+		/// One past last character belongs to the run after last
+		size_t block_of(size_t character_index) const noexcept
+		{
+			size_t block = 0;
+			while (block < runs && ends[block] <= character_index) { ++block; }
+			return block;
+		}
+
+		/// Get run by index. Run after the last one is empty
+		unicode::run run(size_t block) const noexcept
+		{
+			size_t first = 0;
+			size_t byte_offset = 0;
+			for (size_t i = 0; i < block; ++i)
+			{
+				byte_offset += (ends[i] - first) * sizes[i];
+				first = ends[i];
+			}
+			if (block == runs) { return {block, first, first, byte_offset, 0}; }
+			return {block, first, ends[block], byte_offset, sizes[block]};
+		}
+
+		/// Get offset of the first byte of character
+		size_t byte_offset_of(size_t character_index) const noexcept
+		{
+			return run(block_of(character_index)).byte_offset_of(character_index);
+		}
+
+		/// Get run of a single character, that contains byte
+		unicode::run character_at_byte(size_t byte_offset) const noexcept
+		{
+			assert(byte_offset < bytes() && "out of range");
+			auto run = this->run(0);
+			while (run.byte_end() <= byte_offset) { run = this->run(run.block + 1); }
+			auto index =
+				run.first + (byte_offset - run.byte_offset) / run.character_size;
+			return {
+				run.block,
+				index,
+				index + 1,
+				run.byte_offset_of(index),
+				run.character_size
+			};
+		}
+
+		/// Get index of character, that contains code unit, counting them.
+		/// Offset of the end of string maps to number of characters
+		size_t character_of_unit(
+			std::string_view bytes,
+			size_t unit_offset,
+			code_unit unit
+		) const noexcept
+		{
+			size_t units = 0;
+			for (size_t block = 0; block < runs; ++block)
+			{
+				auto run = this->run(block);
+				for (auto index = run.first; index < run.last; ++index)
+				{
+					units += count_code_units(
+						bytes.substr(run.byte_offset_of(index), run.character_size)
+					)[unit];
+					if (units > unit_offset) { return index; }
+				}
+			}
+			return characters();
+		}
+	};
+
+	/// Shared layout of the whole string. Empty for inline layouts
+	std::shared_ptr<Layout> layout;
+	union
+	{
+		/// Window over shared layout
+		window frame;
+		/// Layout, encoded inline
+		compact local = {};
+	};
+	/// Is it a layout of the whole string? Runs need no clipping then.
+	/// Inline layouts are always whole
+	bool whole = true;
+
+	/// Layout, encoded inline
+	explicit shared_layout(const compact &local) noexcept : local(local) {}
+
+	/// Window over characters in range [first, last) of shared layout.
+	/// Window is over the whole layout by default
+	explicit shared_layout(
+		std::shared_ptr<Layout> layout,
+		size_t first = 0,
+		std::optional<size_t> last = std::nullopt
+	) noexcept
+		: layout(std::move(layout)), frame{}
+	{
+		auto &parent = *this->layout;
+		auto end = last.value_or(parent.characters());
+		frame.first = first;
+		frame.last = end;
+		whole = first == 0 && end == parent.characters();
+		frame.first_block = parent.block_index_for_character(first);
+		frame.byte_first =
+			parent.run(frame.first_block, first).byte_offset_of(first);
+
+		auto last_block = parent.block_index_for_character(end);
+		frame.byte_last = parent.run(last_block, end).byte_offset_of(end);
+
+		if (first != end)
+		{
+			frame.blocks =
+				parent.block_index_for_character(end - 1) - frame.first_block + 1;
+		}
+	}
+
+	/// Copy layout, keeping its memory resource
+	static Layout copy(const Layout &layout)
+	{
+		if constexpr (requires { Layout(layout, layout.resource()); })
+		{
+			return Layout(layout, layout.resource());
+		}
+		else { return layout; }
+	}
+
+	/// Allocate shared state of layout
+	static std::shared_ptr<Layout> share(Layout layout)
+	{
+		if constexpr (has_resource)
+		{
+			std::pmr::polymorphic_allocator<Layout> allocator(layout.resource());
+			return std::allocate_shared<Layout>(allocator, std::move(layout));
+		}
+		else { return std::make_shared<Layout>(std::move(layout)); }
+	}
+
+	/// Get bytes of the whole string from bytes of window.
+	/// Slices of views point into bytes of the whole string
+	std::string_view whole_string(std::string_view bytes) const noexcept
+	{
+		assert(bytes.size() == this->bytes() && "bytes don't match window");
+		if (whole) { return bytes; }
+		return {bytes.data() - frame.byte_first, layout->bytes()};
+	}
+
+	/// Get run after the given one in window over a part of layout
+	unicode::run next_in_window(const unicode::run &run) const noexcept
+	{
+		if (run.last == characters()) { return this->run(frame.blocks, run.last); }
+		return clip(layout->next(unclip(run)));
+	}
+
+	/// Get run of window from run of the whole layout
+	unicode::run clip(const unicode::run &run) const noexcept
+	{
+		auto begin = std::max(run.first, frame.first);
+		auto end = std::min(run.last, frame.last);
+		return {
+			run.block - frame.first_block,
+			begin - frame.first,
+			end - frame.first,
+			run.byte_offset_of(begin) - frame.byte_first,
+			run.character_size
+		};
+	}
+
+	/// Get run of the whole layout from run of window
+	unicode::run unclip(const unicode::run &run) const noexcept
+	{
+		return {
+			frame.first_block + run.block,
+			frame.first + run.first,
+			frame.first + run.last,
+			frame.byte_first + run.byte_offset,
+			run.character_size
+		};
+	}
+};
+
+} // namespace unicode
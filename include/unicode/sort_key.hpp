@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace unicode
+{
+
+/// Collation key of a string. 
+/// Keys compare byte by byte in the same order as their strings collate
+class sort_key
+{
+public:
+	/// Key of empty string
+	sort_key() = default;
+	/// Take ownership over key bytes
+	explicit sort_key(std::vector<std::uint8_t> bytes) 
+		: bytes(std::move(bytes)) {}
+
+	/// Get sort key of UTF-8 string with default locale comparison rules
+	static sort_key of(std::string_view str);
+
+	/// Get bytes of key
+	std::span<const std::uint8_t> data() const noexcept { return bytes; }
+	/// Get size of key in bytes
+	size_t size() const noexcept { return bytes.size(); }
+
+	bool operator==(const sort_key &other) const noexcept
+	{
+		return compare(data(), other.data()) == 0;
+	}
+
+	auto operator<=>(const sort_key &other) const noexcept
+	{
+		return compare(data(), other.data());
+	}
+
+	/// Compare raw key bytes
+	static std::strong_ordering compare(
+		std::span<const std::uint8_t> lhs, 
+		std::span<const std::uint8_t> rhs
+	) noexcept
+	{
+		auto size = std::min(lhs.size(), rhs.size());
+		if (size != 0)
+		{
+			if (auto res = std::memcmp(lhs.data(), rhs.data(), size))
+			{
+				return res <=> 0;
+			}
+		}
+		return lhs.size() <=> rhs.size();
+	}
+
+private:
+	/// Bytes of key
+	std::vector<std::uint8_t> bytes;
+};
+
+/// Sort keys of many strings, stored in one contiguous buffer
+class sort_keys
+{
+public:
+	/// No keys
+	sort_keys() = default;
+	/// Compute keys of UTF-8 strings with default locale comparison rules
+	explicit sort_keys(std::span<const std::string_view> strings);
+
+	/// Get number of keys
+	size_t size() const noexcept { return offsets.size() - 1; }
+
+	/// Get bytes of key by index
+	std::span<const std::uint8_t> operator[](size_t index) const noexcept
+	{
+		return std::span(bytes).subspan(
+			offsets[index], offsets[index + 1] - offsets[index]
+		);
+	}
+
+	/// Get indexes of keys in ascending order. 
+	/// Stable order keeps indexes of equal keys in ascending order too
+	std::vector<size_t> order(bool stable = false) const;
+
+private:
+	/// Bytes of all keys
+	std::vector<std::uint8_t> bytes;
+	/// Offsets of keys inside of bytes, with extra offset for the end
+	std::vector<size_t> offsets = {0};
+};
+
+} // namespace unicode
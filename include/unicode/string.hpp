@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <string_view>
+
+#include "unicode/layout.hpp"
+#include "unicode/string_view.hpp"
+#include "unicode/comparable_interface.hpp"
+
+namespace unicode
+{
+
+/// Owning string of unicode characters.
+/// Keeps its layout up to date on changes, re-segmenting 
+/// only characters around them, so appends cost amortized O(appended bytes).
+/// Layout must not refer to bytes of string, as they move with it
+/// @tparam Layout layout of string, e.g. unicode::basic_layout
+template<typename Layout = unicode::layout>
+class basic_string : public comparable_interface<basic_string<Layout>>
+{
+public:
+	using layout_type = Layout;
+	/// View over string, that refers to its layout
+	using view_type = basic_string_view<layout_reference<Layout>>;
+	using value_type = character_view;
+	using size_type = std::string::size_type;
+
+	/// Number of characters till the end of string
+	static constexpr size_type npos = std::string::npos;
+
+	/// Empty string
+	basic_string() = default;
+	/// String from bytes
+	basic_string(const char *bytes) : basic_string(std::string(bytes)) {}
+	/// String from bytes
+	basic_string(std::string_view bytes) : basic_string(std::string(bytes)) {}
+	/// String from bytes
+	basic_string(std::string bytes) 
+		: bytes(std::move(bytes)), layout(Layout::of(this->bytes)) {}
+
+	/// Get view over string. Layout isn't copied
+	view_type view() const noexcept
+	{
+		return view_type(bytes, layout_reference<Layout>(layout));
+	}
+	/// Get view over string. Layout isn't copied
+	operator view_type() const noexcept { return view(); }
+
+	/// Get underlying bytes
+	operator std::string_view() const noexcept { return bytes; }
+	/// Get underlying bytes
+	const std::string &str() const noexcept { return bytes; }
+
+	/// Get layout of string
+	const Layout &get_layout() const noexcept { return layout; }
+
+	/// Get size of string in characters
+	size_t size() const noexcept(is_nothrow_accessible<Layout>) 
+	{ 
+		return layout.characters(); 
+	}
+
+	/// Is string empty?
+	[[nodiscard]]
+	bool empty() const noexcept { return bytes.empty(); }
+
+	/// Get character by index
+	character_view operator[](size_type index) const 
+		noexcept(is_nothrow_accessible<Layout>)
+	{
+		return view()[index];
+	}
+
+	/// Get first character
+	character_view front() const noexcept(is_nothrow_accessible<Layout>) 
+	{ 
+		return view().front(); 
+	}
+
+	/// Get last character
+	character_view back() const noexcept(is_nothrow_accessible<Layout>) 
+	{ 
+		return view().back(); 
+	}
+
+	/// Append text to the end of string
+	basic_string &append(std::string_view text)
+	{
+		return replace(size(), 0, text);
+	}
+	/// Append text to the end of string
+	basic_string &operator+=(std::string_view text) { return append(text); }
+
+	/// Append character to the end of string
+	void push_back(std::string_view character) { append(character); }
+
+	/// Insert text before character
+	basic_string &insert(size_type index, std::string_view text)
+	{
+		return replace(index, 0, text);
+	}
+
+	/// Erase characters, starting with specified one
+	basic_string &erase(size_type index, size_type count = npos)
+	{
+		return replace(index, count, {});
+	}
+
+	/// Replace characters, starting with specified one, with text
+	basic_string &replace(
+		size_type index, 
+		size_type count, 
+		std::string_view text
+	)
+	{
+		assert(index <= size() && "out of range");
+
+		count = std::min(count, size() - index);
+		auto first = byte_offset_of(index);
+		auto last = byte_offset_of(index + count);
+		bytes.replace(first, last - first, text);
+		layout.update(bytes, {first, last - first}, text.size());
+		return *this;
+	}
+
+	/// Get number of bytes, used by string and its layout
+	size_t memory_usage() const noexcept 
+	{ 
+		return bytes.capacity() + layout.memory_usage(); 
+	}
+
+private:
+	/// Bytes of string
+	std::string bytes;
+	/// Layout of string
+	Layout layout;
+
+	/// Get offset of the first byte of character.
+	/// One past last character starts at the end of string
+	size_t byte_offset_of(size_type index) const 
+		noexcept(is_nothrow_accessible<Layout>)
+	{
+		auto run = layout.run(layout.block_index_for_character(index), index);
+		return run.byte_offset_of(index);
+	}
+};
+
+/// String of unicode characters with default layout
+using string = basic_string<>;
+
+} // namespace unicode
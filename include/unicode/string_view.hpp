@@ -1,30 +1,81 @@
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "unicode/layout.hpp"
+#include "unicode/shared_layout.hpp"
+#include "unicode/translation_layout.hpp"
 #include "unicode/comparable_interface.hpp"
 #include "unicode/character_view.hpp"
 
 namespace unicode
 {
 
+template<typename Layout>
+class basic_string;
+
 /// View over unicode characters
-class string_view : public comparable_interface<string_view>
+/// @tparam Layout layout of string, e.g. unicode::basic_layout
+template<typename Layout = unicode::layout>
+class basic_string_view 
+	: public comparable_interface<basic_string_view<Layout>>
 {
 public:
+	using layout_type = Layout;
 	using value_type = character_view;
 	using size_type = std::string_view::size_type;
 	using difference_type = std::string_view::difference_type;
 
-	/// Iterator over unicode characters
+	/// Iterator over unicode characters.
+	/// Keeps cursor inside of current block, 
+	/// so that sequential iteration doesn't search for blocks
 	class iterator
 	{
 	private:
 		/// View over string
-		const string_view *view = nullptr; 
+		const basic_string_view *view = nullptr; 
+		/// Position of iterator inside of layout
+		struct cursor
+		{
+			/// Run of characters of same size, containing current one
+			unicode::run run;
+			/// First byte of current character
+			const char *position = nullptr;
+		};
+		/// Position of iterator inside of layout
+		cursor current;
+
+		/// Create iterator at already known cursor
+		iterator(const basic_string_view &view, cursor current) noexcept
+			: view(&view), current(current), index(current.run.first)
+		{}
+
+		/// Get cursor for character, searching for its block if needed.
+		/// Doesn't take iterator itself, so it may stay in registers
+		static cursor seek(
+			const basic_string_view &view, 
+			cursor current, 
+			size_t index
+		) noexcept(is_nothrow_accessible<Layout>)
+		{
+			auto &layout = view.layout;
+			if (index < current.run.first || index >= current.run.last)
+			{
+				// One past last character belongs to the block after last
+				current.run = layout.run(
+					layout.block_index_for_character(index), 
+					index
+				);
+			}
+			current.position = view.bytes.data() + current.run.byte_offset_of(index);
+			return current;
+		}
+
 	public:
 		using value_type = character_view;
 		using difference_type = std::ptrdiff_t;
@@ -36,28 +87,54 @@ public:
 		size_t index = 0;
 
 		/// Create iterator over unicode characters for string view
-		iterator(const string_view &view, size_t index = 0) noexcept
-			: view(&view), index(index)
+		iterator(const basic_string_view &view, size_t index = 0) 
+			noexcept(is_nothrow_accessible<Layout>)
+			: view(&view), current(seek(view, {}, index)), index(index)
 		{}
 
+		/// Create iterator for one past last character of string view.
+		/// It starts at the empty run after the last block, 
+		/// so its block isn't searched
+		static iterator past_end(const basic_string_view &view) 
+			noexcept(is_nothrow_accessible<Layout>)
+		{
+			auto blocks = view.layout.block_count();
+			auto size = view.size();
+			return iterator(
+				view, 
+				{
+					{blocks, size, size, view.bytes.size(), 0}, 
+					view.bytes.data() + view.bytes.size()
+				}
+			);
+		}
+
 		/// Random access iterator methods
-		iterator &operator+=(difference_type offset) noexcept
+		iterator &operator+=(difference_type offset) 
+			noexcept(is_nothrow_accessible<Layout>)
 		{
 			index += offset;
+			current = seek(*view, current, index);
 			return *this;
 		}
-		iterator &operator-=(difference_type offset) noexcept
+		iterator &operator-=(difference_type offset) 
+			noexcept(is_nothrow_accessible<Layout>)
 		{
 			index -= offset;
+			current = seek(*view, current, index);
 			return *this;
 		}
-		iterator operator+(difference_type offset) const noexcept
+		iterator operator+(difference_type offset) const 
+			noexcept(is_nothrow_accessible<Layout>)
 		{
-			return iterator(*view, index + offset);
+			auto result = *this;
+			return result += offset;
 		}
-		iterator operator-(difference_type offset) const noexcept
+		iterator operator-(difference_type offset) const 
+			noexcept(is_nothrow_accessible<Layout>)
 		{
-			return iterator(*view, index - offset);
+			auto result = *this;
+			return result -= offset;
 		}
 		difference_type operator-(const iterator &other) const noexcept
 		{
@@ -67,31 +144,55 @@ public:
 			);
 			return index - other.index;
 		}
-		iterator &operator++() noexcept
+		iterator &operator++() 
+			noexcept(is_nothrow_accessible<Layout>)
 		{
 			++index;
+			current.position += current.run.character_size;
+			// Runs are adjacent, so position is already correct.
+			// Past the last character there is an empty run
+			if (index == current.run.last) 
+			{ 
+				current.run = view->layout.next(current.run); 
+			}
 			return *this;
 		}
-		iterator operator++(int) noexcept
+		iterator operator++(int) 
+			noexcept(is_nothrow_accessible<Layout>)
 		{
-			return iterator(*view, index++);
+			auto result = *this;
+			++*this;
+			return result;
 		}
 		iterator &operator--() noexcept
 		{
+			if (index == current.run.first) 
+			{ 
+				current.run = view->layout.previous(current.run); 
+			}
 			--index;
+			current.position -= current.run.character_size;
 			return *this;
 		}
 		iterator operator--(int) noexcept
 		{
-			return iterator(*view, index--);
+			auto result = *this;
+			--*this;
+			return result;
 		}
-		value_type operator*() const noexcept
+		value_type operator*() const 
+			noexcept(is_nothrow_accessible<Layout>)
 		{
-			return view->operator[](index);
+			// Run after the last one is empty, so lazy layouts aren't completed
+			assert(index < current.run.last && "out of range");
+			return character_view(
+				std::string_view(current.position, current.run.character_size)
+			);
 		}
-		value_type operator[](difference_type offset) const noexcept
+		value_type operator[](difference_type offset) const 
+			noexcept(is_nothrow_accessible<Layout>)
 		{
-			return view->operator[](index + offset);
+			return *(*this + offset);
 		}
 		bool operator==(const iterator &other) const noexcept
 		{
@@ -120,132 +221,374 @@ public:
 	using reference = character_view;
 	using const_reference = character_view;
 
+	/// Number of characters till the end of string
+	static constexpr size_type npos = std::string_view::npos;
+
 	/// View over empty string
-	string_view() = default;
+	basic_string_view() = default;
 	/// View over string
-	string_view(const char *bytes) 
-		: string_view(std::string_view(bytes)) {}
+	basic_string_view(const char *bytes) 
+		: basic_string_view(std::string_view(bytes)) {}
 	/// View over string
-	string_view(std::string_view bytes) 
-		: bytes(bytes), layout(layout::of(bytes)) {}
+	basic_string_view(std::string_view bytes) 
+		: bytes(bytes), layout(Layout::of(bytes)) {}
 	/// View over string
-	string_view(const std::string &bytes)
-		: string_view(std::string_view(bytes)) {}
+	basic_string_view(const std::string &bytes)
+		: basic_string_view(std::string_view(bytes)) {}
+	/// View over unicode string with copy of its layout.
+	/// String isn't segmented again
+	template<typename Other>
+		requires 
+			(!std::same_as<Layout, layout_reference<Other>>) &&
+			std::constructible_from<Layout, const Other &>
+	basic_string_view(const basic_string<Other> &string)
+		: basic_string_view(string.str(), Layout(string.get_layout())) {}
+	/// View over unicode string, whose layout can't be copied.
+	/// Otherwise string would be segmented again through its bytes.
+	/// Use view() of string or pass its str() explicitly
+	template<typename Other>
+		requires 
+			(!std::same_as<Layout, layout_reference<Other>>) &&
+			(!std::constructible_from<Layout, const Other &>)
+	basic_string_view(const basic_string<Other> &string) = delete;
+	/// View over string with layout, allocated from memory resource.
+	/// Layout must support memory resources, e.g. unicode::basic_layout
+	basic_string_view(std::string_view bytes, std::pmr::memory_resource *resource)
+		: bytes(bytes), layout(Layout::of(bytes, resource)) {}
+	/// View over string with already known layout
+	basic_string_view(std::string_view bytes, Layout layout)
+		: bytes(bytes), layout(std::move(layout)) 
+	{
+		assert(this->layout.bytes() == bytes.size() && "layout of other string");
+	}
 
 	/// Get iterator for first character
-	iterator begin() const noexcept
+	iterator begin() const noexcept(is_nothrow_accessible<Layout>)
 	{
 		return iterator(*this);
 	}
 	/// Get iterator for one past last character
-	iterator end() const noexcept
+	iterator end() const noexcept(is_nothrow_accessible<Layout>)
 	{
-		return iterator(*this, size());
+		return iterator::past_end(*this);
 	}
 	/// Get iterator for first character
-	const_iterator cbegin() const noexcept
+	const_iterator cbegin() const noexcept(is_nothrow_accessible<Layout>)
 	{
 		return begin();
 	}
 	/// Get iterator for one past last character
-	const_iterator cend() const noexcept
+	const_iterator cend() const noexcept(is_nothrow_accessible<Layout>)
 	{
 		return end();
 	}
 	/// Get reverse iterator for last character
-	reverse_iterator rbegin() const noexcept
+	reverse_iterator rbegin() const noexcept(is_nothrow_accessible<Layout>)
 	{
 		return reverse_iterator(end());
 	}
 	/// Get reverse iterator for one before first character
-	reverse_iterator rend() const noexcept
+	reverse_iterator rend() const noexcept(is_nothrow_accessible<Layout>)
 	{
 		return reverse_iterator(begin());
 	}
 	/// Get reverse iterator for last character
-	const_reverse_iterator crbegin() const noexcept
+	const_reverse_iterator crbegin() const noexcept(is_nothrow_accessible<Layout>)
 	{
 		return const_reverse_iterator(cend());
 	}
 	/// Get reverse iterator for one before first character
-	const_reverse_iterator crend() const noexcept
+	const_reverse_iterator crend() const noexcept(is_nothrow_accessible<Layout>)
 	{
 		return const_reverse_iterator(cbegin());
 	}
 
 	/// Get first character
-	character_view front() const noexcept
+	character_view front() const noexcept(is_nothrow_accessible<Layout>)
 	{
 		return operator[](0);
 	}
 
 	/// Get last character
-	character_view back() const noexcept
+	character_view back() const noexcept(is_nothrow_accessible<Layout>)
 	{
 		return operator[](size() - 1);
 	}
 
-	/// Get size of string in characters
-	constexpr size_t size() const noexcept 
-	{
-		if (layout.offsets.empty()) { return 0; }
-
-		auto &last_block = layout.blocks.back();
-		return 
-			layout.offsets.back() + 
-				(bytes.size() - last_block.byte_offset) / 
-				last_block.character_size; 
+	/// Get size of string in characters.
+	/// Layouts, that segment string on demand, may allocate, 
+	/// so access to characters is noexcept only for other layouts
+	size_t size() const noexcept(is_nothrow_accessible<Layout>) 
+	{ 
+		return layout.characters(); 
 	}
 
 	/// Is string empty?
 	[[nodiscard]]
-	bool empty() const noexcept { return size() == 0; }
+	bool empty() const noexcept(is_nothrow_accessible<Layout>) 
+	{ 
+		return size() == 0; 
+	}
 
 	/// Get underlying bytes
 	constexpr operator std::string_view() const noexcept { return bytes; }
 
+	/// Get layout of string
+	const Layout &get_layout() const noexcept { return layout; }
+
+	/// Get number of bytes, used by layout of string
+	size_t memory_usage() const noexcept { return layout.memory_usage(); }
+
 	/// Update layout after change in string
-	void update() { layout = layout::of(bytes); }
+	void update() { layout.update(bytes); }
+
+	/// Update layout after bytes in changed range of string
+	/// were replaced with new_length bytes.
+	/// Bytes of changed string may be moved
+	void update(
+		std::string_view bytes, 
+		byte_range changed, 
+		size_t new_length
+	)
+	{
+		this->bytes = bytes;
+		layout.update(bytes, changed, new_length);
+	}
 
 	/// Swap 2 views
-	void swap(string_view other)
+	void swap(basic_string_view other)
 	{
 		std::swap(bytes, other.bytes);
 		std::swap(layout, other.layout);
 	}
 
 	/// Get character by absolute index
-	character_view operator[](size_type index) const noexcept
+	character_view operator[](size_type index) const 
+		noexcept(is_nothrow_accessible<Layout>)
 	{
-		assert(index < size() && "out of range");
-
 		auto block_index = layout.block_index_for_character(index);
 
-		auto offset = layout.offsets[block_index];
-		auto &block = layout.blocks[block_index];
+		auto run = layout.run(block_index, index);
+		// Run after the last one is empty, so lazy layouts aren't completed
+		assert(index < run.last && "out of range");
 
 		return character_view(
-			bytes.substr(
-				block.byte_offset + (index - offset) * block.character_size, block.character_size
-			)
+			bytes.substr(run.byte_offset_of(index), run.character_size)
 		);
 	}
 
 	/// Get character by index. Negative indexes are relative to end of string
 	template<std::signed_integral index_t>
-	character_view operator[](index_t index) const noexcept
+	character_view operator[](index_t index) const 
+		noexcept(is_nothrow_accessible<Layout>)
 	{
 		if (index < 0) { index += size(); }
-		assert(0 <= index && size_type(index) < size() && "out of range");
+		assert(0 <= index && "out of range");
 
 		return operator[](static_cast<size_type>(index));
 	}
 
+	/// Get view over count characters, starting with specified one.
+	/// Layout of this view is shared, so characters aren't segmented again.
+	/// Layout must support slicing, e.g. unicode::shared_layout
+	basic_string_view substr(size_type index, size_type count = npos) const
+	{
+		assert(index <= size() && "out of range");
+
+		count = std::min(count, size() - index);
+		auto first = index_to_byte(index);
+		auto last = index_to_byte(index + count);
+		return basic_string_view(
+			bytes.substr(first, last - first), 
+			layout.slice(index, index + count)
+		);
+	}
+
+	/// Get view over characters in range [first, last).
+	/// Layout must support slicing, e.g. unicode::shared_layout
+	basic_string_view slice(iterator first, iterator last) const
+	{
+		assert(first <= last && "wrong range");
+		return substr(first.index, last.index - first.index);
+	}
+
+	/// Get offset of the first byte of character. 
+	/// Index of one past last character maps to size of string in bytes
+	size_type index_to_byte(size_type index) const 
+		noexcept(is_nothrow_accessible<Layout>)
+	{
+		auto block_index = layout.block_index_for_character(index);
+		auto run = layout.run(block_index, index);
+		assert(index <= run.last && "out of range");
+		return run.byte_offset_of(index);
+	}
+
+	/// Get index of character, that contains byte.
+	/// Offset of the end of string maps to size().
+	/// Layout must find characters by bytes, e.g. unicode::basic_layout
+	size_type byte_to_index(size_type byte_offset) const 
+		noexcept(is_nothrow_accessible<Layout>)
+	{
+		assert(byte_offset <= bytes.size() && "out of range");
+
+		if (byte_offset == bytes.size()) { return size(); }
+		return layout.character_at_byte(byte_offset).first;
+	}
+
+	/// Get offset of character in code points.
+	/// Layout must have translation columns, e.g. unicode::translation_layout
+	size_type index_to_code_point(size_type index) const noexcept
+	{
+		return layout.units_before(bytes, index, code_unit::code_point);
+	}
+
+	/// Get index of character, that contains code point.
+	/// Layout must have translation columns, e.g. unicode::translation_layout
+	size_type code_point_to_index(size_type code_point_offset) const noexcept
+	{
+		return layout.character_of_unit(
+			bytes, code_point_offset, code_unit::code_point
+		);
+	}
+
+	/// Get offset of character in UTF-16 code units.
+	/// Layout must have translation columns, e.g. unicode::translation_layout
+	size_type index_to_utf16(size_type index) const noexcept
+	{
+		return layout.units_before(bytes, index, code_unit::utf16);
+	}
+
+	/// Get index of character, that contains UTF-16 code unit.
+	/// Layout must have translation columns, e.g. unicode::translation_layout
+	size_type utf16_to_index(size_type utf16_offset) const noexcept
+	{
+		return layout.character_of_unit(bytes, utf16_offset, code_unit::utf16);
+	}
+
+	/// Find the first occurrence of needle, starting with character index.
+	/// Matches must start and end at character boundaries, 
+	/// e.g. "e" isn't found in "e\u0301".
+	/// Returns index of its first character or npos.
+	/// Layout must find characters by bytes, e.g. unicode::basic_layout
+	size_type find(std::string_view needle, size_type index = 0) const 
+		noexcept(is_nothrow_accessible<Layout>)
+	{
+		if (index > size()) { return npos; }
+		if (needle.empty()) { return index; }
+
+		auto match = find_match(needle, index_to_byte(index));
+		return match ? match->first : npos;
+	}
+
+	/// Find the last occurrence of needle, 
+	/// that starts not after character index.
+	/// Matches must start and end at character boundaries.
+	/// Returns index of its first character or npos.
+	/// Layout must find characters by bytes, e.g. unicode::basic_layout
+	size_type rfind(std::string_view needle, size_type index = npos) const 
+		noexcept(is_nothrow_accessible<Layout>)
+	{
+		index = std::min(index, size());
+		if (needle.empty()) { return index; }
+		if (needle.size() > bytes.size()) { return npos; }
+
+		// Candidate inside of a character moves to its start, 
+		// and candidate at the start moves before it
+		auto position = std::min(index_to_byte(index), bytes.size() - needle.size());
+		while ((position = bytes.rfind(needle, position)) != npos)
+		{
+			auto character = layout.character_at_byte(position);
+			if (character.byte_offset < position)
+			{
+				position = character.byte_offset;
+				continue;
+			}
+			if (is_boundary(position + needle.size())) { return character.first; }
+			if (position == 0) { break; }
+			--position;
+		}
+		return npos;
+	}
+
+	/// Does string contain needle, that starts and ends at character boundaries?
+	/// Layout must find characters by bytes, e.g. unicode::basic_layout
+	bool contains(std::string_view needle) const noexcept(is_nothrow_accessible<Layout>)
+	{
+		return find(needle) != npos;
+	}
+
+	/// Find indexes of the first characters of all occurrences of needle, 
+	/// that don't overlap and start and end at character boundaries.
+	/// Empty needle is found before each character and at the end.
+	/// Layout must find characters by bytes, e.g. unicode::basic_layout
+	std::vector<size_type> find_all(std::string_view needle) const
+	{
+		std::vector<size_type> indexes;
+		if (needle.empty())
+		{
+			indexes.resize(size() + 1);
+			for (size_type i = 0; i <= size(); ++i) { indexes[i] = i; }
+			return indexes;
+		}
+
+		for (
+			auto match = find_match(needle, 0); 
+			match; 
+			match = find_match(needle, match->byte_offset + needle.size())
+		)
+		{
+			indexes.push_back(match->first);
+		}
+		return indexes;
+	}
+
 private:
 	/// Bytes of string
 	std::string_view bytes;
 	/// Layout of string
-	layout layout;
+	Layout layout;
+
+	/// Is byte the first one of character or the end of string?
+	bool is_boundary(size_type byte_offset) const noexcept
+	{
+		return 
+			byte_offset == bytes.size() ||
+			layout.character_at_byte(byte_offset).byte_offset == byte_offset;
+	}
+
+	/// Find run of the first character of non-empty needle,
+	/// that starts not before byte and ends at character boundary.
+	/// Bytes are searched by std::string_view::find, that uses memchr,
+	/// and only candidates are checked with layout
+	std::optional<unicode::run> find_match(
+		std::string_view needle, 
+		size_type byte_offset
+	) const noexcept
+	{
+		// Candidates inside of a character are skipped with it
+		while ((byte_offset = bytes.find(needle, byte_offset)) != npos)
+		{
+			auto character = layout.character_at_byte(byte_offset);
+			if (
+				character.byte_offset == byte_offset && 
+				is_boundary(byte_offset + needle.size())
+			)
+			{
+				return character;
+			}
+			byte_offset = character.byte_end();
+		}
+		return std::nullopt;
+	}
 };
+
+/// View over unicode characters with default layout.
+/// Copies and slices of view share its layout
+using string_view = basic_string_view<shared_layout<layout>>;
+/// View over unicode characters, that translates offsets of characters
+/// to code points and UTF-16 code units.
+/// Copies and slices of view share its layout
+using translation_string_view = 
+	basic_string_view<shared_layout<translation_layout>>;
 	
 } // namespace unicode
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "unicode/layout.hpp"
+#include "unicode/utility/packed_vector.hpp"
+
+namespace unicode
+{
+
+/// Layout with extra columns for translation of character indexes
+/// to offsets in code points and UTF-16 code units and back.
+/// Columns keep offsets of every interval-th character, 
+/// so translation searches a column in O(log n) 
+/// and counts code units of at most interval characters.
+/// Columns are allocated from memory resource of layout
+/// @tparam Index policy for searching blocks, see unicode::offset_index
+template<typename Index = offset_index::binary_search>
+class basic_translation_layout : public basic_layout<Index>
+{
+public:
+	/// Number of characters between offsets in columns
+	static constexpr size_t interval = 64;
+
+	/// Layout of empty string
+	basic_translation_layout() { build_columns({}); }
+
+	/// Add translation columns to layout of string
+	basic_translation_layout(basic_layout<Index> layout, std::string_view bytes)
+		: basic_layout<Index>(std::move(layout)),
+		  code_point_offsets(this->resource()),
+		  utf16_offsets(this->resource())
+	{
+		build_columns(bytes);
+	}
+
+	/// Copy layout, allocating blocks and columns from resource
+	basic_translation_layout(
+		const basic_translation_layout &other, 
+		std::pmr::memory_resource *resource
+	)
+		: basic_layout<Index>(other, resource),
+		  code_point_offsets(other.code_point_offsets, resource),
+		  utf16_offsets(other.utf16_offsets, resource)
+	{}
+
+	/// Get layout of string with translation columns, allocated from resource
+	static basic_translation_layout of(
+		std::string_view bytes,
+		std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+	)
+	{
+		return basic_translation_layout(
+			basic_layout<Index>::of(bytes, resource), 
+			bytes
+		);
+	}
+
+	/// Rebuild layout after change in string, keeping memory resource
+	void update(std::string_view bytes) { *this = of(bytes, this->resource()); }
+
+	/// Update layout after bytes in changed range of string 
+	/// were replaced with new_length bytes. 
+	/// Blocks are updated incrementally. Columns are recounted 
+	/// from the first changed block until blocks are shifted, 
+	/// and offsets after that are shifted too
+	void update(std::string_view bytes, byte_range changed, size_t new_length)
+	{
+		// Blocks before the one, that contains the character 
+		// before the character with the byte before change, are kept
+		size_t kept = 0;
+		if (changed.offset != 0 && this->characters() != 0)
+		{
+			auto character = this->character_at_byte(changed.offset - 1);
+			if (character.first != 0) 
+			{ 
+				character = this->character_at_byte(character.byte_offset - 1); 
+			}
+			kept = this->offset(character.block);
+		}
+
+		auto old_characters = this->characters();
+		auto shifted = basic_layout<Index>::update(bytes, changed, new_length);
+		update_columns(bytes, kept, shifted, old_characters);
+	}
+
+	/// Get number of code units before character
+	size_t units_before(
+		std::string_view bytes, 
+		size_t character_index, 
+		code_unit unit
+	) const noexcept
+	{
+		assert(character_index <= this->characters() && "out of range");
+
+		auto &column = column_of(unit);
+		if (character_index == this->characters()) { return column.back(); }
+
+		auto checkpoint = character_index / interval;
+		auto first = byte_offset_of(checkpoint * interval);
+		auto last = byte_offset_of(character_index);
+		return 
+			column[checkpoint] + 
+			count_code_units(bytes.substr(first, last - first))[unit];
+	}
+
+	/// Get index of character, that contains code unit.
+	/// Offset of the end of string maps to number of characters
+	size_t character_of_unit(
+		std::string_view bytes, 
+		size_t unit_offset, 
+		code_unit unit
+	) const noexcept
+	{
+		auto &column = column_of(unit);
+		assert(unit_offset <= column.back() && "out of range");
+		if (unit_offset == column.back()) { return this->characters(); }
+
+		// The last checkpoint, that starts not after code unit
+		auto checkpoint = column.visit(
+			[&](auto offsets)
+			{
+				return size_t(
+					std::upper_bound(
+						offsets.begin(), offsets.end() - 1, unit_offset
+					) - 
+					offsets.begin() - 
+					1
+				);
+			}
+		);
+
+		auto index = checkpoint * interval;
+		auto units = column[checkpoint];
+		auto run = this->run(this->block_index_for_character(index), index);
+		for (;; ++index)
+		{
+			if (index == run.last) { run = this->next(run); }
+			units += count_code_units(
+				bytes.substr(run.byte_offset_of(index), run.character_size)
+			)[unit];
+			if (units > unit_offset) { return index; }
+		}
+	}
+
+	/// Get number of bytes, used by layout
+	size_t memory_usage() const noexcept
+	{
+		return 
+			basic_layout<Index>::memory_usage() + 
+			code_point_offsets.memory_usage() + 
+			utf16_offsets.memory_usage();
+	}
+
+private:
+	/// Code point offsets of every interval-th character, 
+	/// followed by number of code points
+	utility::packed_vector code_point_offsets;
+	/// UTF-16 offsets of every interval-th character,
+	/// followed by number of UTF-16 code units
+	utility::packed_vector utf16_offsets;
+
+	/// Get column of offsets in code units
+	const utility::packed_vector &column_of(code_unit unit) const noexcept
+	{
+		return unit == code_unit::code_point ? code_point_offsets : utf16_offsets;
+	}
+
+	/// Get offset of the first byte of character
+	size_t byte_offset_of(size_t character_index) const noexcept
+	{
+		auto block = this->block_index_for_character(character_index);
+		return this->run(block, character_index).byte_offset_of(character_index);
+	}
+
+	/// Count code units between checkpoints in a single pass over string
+	void build_columns(std::string_view bytes)
+	{
+		code_point_offsets.clear();
+		utf16_offsets.clear();
+
+		code_unit_counts total;
+		size_t start = 0;
+		for (size_t index = 0; index < this->characters(); index += interval)
+		{
+			auto end = byte_offset_of(
+				std::min(index + interval, this->characters())
+			);
+			code_point_offsets.push_back(total.code_points);
+			utf16_offsets.push_back(total.utf16);
+
+			auto counts = count_code_units(bytes.substr(start, end - start));
+			total.code_points += counts.code_points;
+			total.utf16 += counts.utf16;
+			start = end;
+		}
+		code_point_offsets.push_back(total.code_points);
+		utf16_offsets.push_back(total.utf16);
+
+		code_point_offsets.shrink_to_fit();
+		utf16_offsets.shrink_to_fit();
+	}
+
+	/// Update columns after update of blocks.
+	/// Characters before kept one are unchanged, and characters 
+	/// starting with shifted one are old ones, moved by the same number 
+	/// of characters and code units. Offsets between them are counted, 
+	/// and offsets after them are old offsets of characters at the same 
+	/// distance from shifted one, found by counting code units 
+	/// from the nearest old checkpoint
+	void update_columns(
+		std::string_view bytes, 
+		size_t kept, 
+		size_t shifted, 
+		size_t old_characters
+	)
+	{
+		// Differences are computed modulo 2^64, so they may be negative
+		auto character_shift = this->characters() - old_characters;
+		auto old_shifted = shifted - character_shift;
+		// Characters are mostly counted inside of a single run
+		auto count = [&](size_t first, size_t last)
+		{
+			auto run = this->run(this->block_index_for_character(first), first);
+			auto begin = run.byte_offset_of(first);
+			auto end = 
+				last <= run.last ? run.byte_offset_of(last) : byte_offset_of(last);
+			return count_code_units(bytes.substr(begin, end - begin));
+		};
+		auto old_entry = [&](size_t entry)
+		{
+			return code_unit_counts{code_point_offsets[entry], utf16_offsets[entry]};
+		};
+		// Get old offset of character, that isn't before shifted one
+		auto old_offset = [&](size_t old_index)
+		{
+			if (old_index == old_characters) 
+			{ 
+				return old_entry(code_point_offsets.size() - 1); 
+			}
+
+			auto entry = old_index / interval;
+			auto previous = entry * interval;
+			auto next = std::min(previous + interval, old_characters);
+			if (old_index == previous) { return old_entry(entry); }
+			if (previous >= old_shifted && old_index - previous < next - old_index)
+			{
+				return old_entry(entry) + count(
+					previous + character_shift, old_index + character_shift
+				);
+			}
+			return old_entry(entry + 1) - count(
+				old_index + character_shift, next + character_shift
+			);
+		};
+
+		// New offsets are collected in buffers, as old ones are still read
+		thread_local std::vector<size_t> code_points, utf16;
+		code_points.clear();
+		utf16.clear();
+		auto push = [](const code_unit_counts &units)
+		{
+			code_points.push_back(units.code_points);
+			utf16.push_back(units.utf16);
+		};
+
+		// Offsets up to shifted character are counted
+		auto checkpoint = kept / interval;
+		auto index = checkpoint * interval;
+		auto units = old_entry(checkpoint);
+		for (; index < this->characters() && index <= shifted; index += interval)
+		{
+			push(units);
+			units = units + count(index, std::min(index + interval, shifted));
+		}
+
+		// Offsets after it are shifted
+		auto shift = units - old_offset(old_shifted);
+		for (; index < this->characters(); index += interval)
+		{
+			push(old_offset(index - character_shift) + shift);
+		}
+		push(old_offset(old_characters) + shift);
+
+		code_point_offsets.replace(checkpoint, code_point_offsets.size(), code_points);
+		utf16_offsets.replace(checkpoint, utf16_offsets.size(), utf16);
+	}
+};
+
+/// Layout with translation columns and binary search over blocks
+using translation_layout = basic_translation_layout<>;
+
+} // namespace unicode
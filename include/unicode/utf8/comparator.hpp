@@ -0,0 +1,65 @@
+#pragma once
+
+#include <compare>
+#include <memory>
+#include <string_view>
+
+#include "unicode/sort_key.hpp"
+
+namespace unicode::utf8
+{
+
+/// Strength of collation, i.e. which differences are significant
+enum class strength
+{
+	/// Base letters only ("a" == "á" == "A")
+	primary,
+	/// Base letters and accents ("a" == "A", "a" != "á")
+	secondary,
+	/// Base letters, accents and case. Default one
+	tertiary,
+	/// Also punctuation for alternate shifted collation
+	quaternary,
+	/// All differences are significant
+	identical
+};
+
+/// Reusable function object that compares UTF-8 strings with locale rules.
+/// Collator is built only once, copies share it
+class comparator
+{
+public:
+	/// Allow heterogeneous lookup in sorted containers
+	using is_transparent = void;
+
+	/// Comparator with default locale and tertiary strength
+	comparator();
+	/// Comparator with specified locale (e.g "de_DE") and strength
+	explicit comparator(
+		const char *locale, 
+		utf8::strength strength = strength::tertiary
+	);
+
+	/// Compare two UTF-8 strings
+	std::strong_ordering compare(
+		std::string_view lhs, 
+		std::string_view rhs
+	) const noexcept;
+
+	/// Is lhs less than rhs?
+	bool operator()(std::string_view lhs, std::string_view rhs) const noexcept
+	{
+		return compare(lhs, rhs) < 0;
+	}
+
+	/// Get sort key of string, that is ordered as this comparator orders
+	sort_key key(std::string_view str) const;
+
+private:
+	/// Implementation with ICU collator
+	struct implementation;
+	/// Shared immutable collator
+	std::shared_ptr<const implementation> impl;
+};
+
+} // namespace unicode::utf8
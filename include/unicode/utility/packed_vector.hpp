@@ -0,0 +1,300 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <variant>
+
+#include "unicode/utility/small_vector.hpp"
+
+namespace unicode::utility
+{
+
+/// Vector of unsigned integers,
+/// stored with the narrowest width of 16, 32 or 64 bits that fits them.
+/// Width grows on demand, when bigger value is stored.
+/// Up to inline_bytes of elements are stored inline, 
+/// bigger vectors are allocated from polymorphic memory resource.
+/// Copies use default resource, like std::pmr containers
+class packed_vector
+{
+public:
+	/// Number of bytes of elements, that are stored without allocation
+	static constexpr size_t inline_bytes = 16;
+
+	/// Vector of elements of specified width
+	template<typename T>
+	using elements = small_vector<T, inline_bytes / sizeof(T)>;
+
+	/// Empty vector
+	packed_vector() = default;
+
+	/// Empty vector, that allocates memory from resource
+	explicit packed_vector(std::pmr::memory_resource *resource) 
+		: storage(elements<uint16_t>(resource)) {}
+
+	/// Copy elements with their width, allocating memory from resource
+	packed_vector(
+		const packed_vector &other, 
+		std::pmr::memory_resource *resource
+	)
+	{
+		std::visit(
+			[&](auto &values)
+			{
+				using vector = std::decay_t<decltype(values)>;
+				storage.template emplace<vector>(values, resource);
+			},
+			other.storage
+		);
+	}
+
+	/// Copy values with the narrowest width, that fits all of them
+	explicit packed_vector(
+		std::span<const size_t> values,
+		std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+	)
+		: packed_vector(resource)
+	{
+		size_t max = 0;
+		for (auto value : values) { max = std::max(max, value); }
+		fit(max);
+		modify([&](auto &packed) { packed.assign(values.begin(), values.end()); });
+	}
+
+	/// Take elements of specified width as is
+	template<typename T>
+	static packed_vector adopt(elements<T> values)
+	{
+		packed_vector packed;
+		packed.storage.template emplace<elements<T>>(std::move(values));
+		return packed;
+	}
+
+	/// Call function with span of elements of actual width
+	template<typename Function>
+	decltype(auto) visit(Function &&function) const
+	{
+		switch (storage.index())
+		{
+			case 0:
+				return function(std::span(*std::get_if<0>(&storage)));
+			case 1:
+				return function(std::span(*std::get_if<1>(&storage)));
+			default:
+				return function(std::span(*std::get_if<2>(&storage)));
+		}
+	}
+
+	/// Get number of elements
+	size_t size() const noexcept
+	{
+		return visit([](auto values) { return values.size(); });
+	}
+
+	/// Is vector empty?
+	[[nodiscard]]
+	bool empty() const noexcept { return size() == 0; }
+
+	/// Get element by index
+	size_t operator[](size_t index) const noexcept
+	{
+		return visit([index](auto values) { return size_t(values[index]); });
+	}
+
+	/// Get last element
+	size_t back() const noexcept
+	{
+		assert(!empty() && "vector is empty");
+		return operator[](size() - 1);
+	}
+
+	/// Get memory resource of vector
+	std::pmr::memory_resource *resource() const noexcept
+	{
+		return std::visit(
+			[](auto &values) { return values.get_allocator().resource(); },
+			storage
+		);
+	}
+
+	/// Get width of elements in bytes
+	size_t width() const noexcept
+	{
+		return visit([](auto values) { return sizeof(values[0]); });
+	}
+
+	/// Replace element by index
+	void set(size_t index, size_t value)
+	{
+		fit(value);
+		modify([&](auto &values)
+		{
+			using value_type = typename std::decay_t<decltype(values)>::value_type;
+			values[index] = value_type(value);
+		});
+	}
+
+	/// Add element to the end of vector
+	void push_back(size_t value)
+	{
+		fit(value);
+		modify([&](auto &values)
+		{
+			using value_type = typename std::decay_t<decltype(values)>::value_type;
+			values.push_back(value_type(value));
+		});
+	}
+
+	/// Replace elements in range [first, last) with values
+	void replace(size_t first, size_t last, std::span<const size_t> values)
+	{
+		assert(first <= last && last <= size() && "wrong range");
+
+		size_t max = 0;
+		for (auto value : values) { max = std::max(max, value); }
+		fit(max);
+		modify([&](auto &packed)
+		{
+			using value_type = typename std::decay_t<decltype(packed)>::value_type;
+			auto common = std::min(last - first, values.size());
+			std::transform(
+				values.begin(), 
+				values.begin() + common, 
+				packed.begin() + first,
+				[](size_t value) { return value_type(value); }
+			);
+			if (common < values.size())
+			{
+				packed.insert(
+					packed.begin() + last, 
+					values.begin() + common, 
+					values.end()
+				);
+			}
+			else
+			{
+				packed.erase(packed.begin() + first + common, packed.begin() + last);
+			}
+		});
+	}
+
+	/// Replace each element, starting from first, 
+	/// with function(index, element)
+	template<typename Function>
+	void transform(size_t first, Function &&function)
+	{
+		size_t max = 0;
+		visit([&](auto values)
+		{
+			for (auto i = first; i < values.size(); ++i)
+			{
+				max = std::max(max, size_t(function(i, size_t(values[i]))));
+			}
+		});
+		fit(max);
+		modify([&](auto &values)
+		{
+			using value_type = typename std::decay_t<decltype(values)>::value_type;
+			for (auto i = first; i < values.size(); ++i)
+			{
+				values[i] = value_type(function(i, size_t(values[i])));
+			}
+		});
+	}
+
+	/// Remove last element
+	void pop_back() noexcept
+	{
+		modify([](auto &values) { values.pop_back(); });
+	}
+
+	/// Remove all elements. Width is kept
+	void clear() noexcept
+	{
+		modify([](auto &values) { values.clear(); });
+	}
+
+	/// Reserve memory for elements
+	void reserve(size_t capacity)
+	{
+		modify([capacity](auto &values) { values.reserve(capacity); });
+	}
+
+	/// Free unused memory
+	void shrink_to_fit()
+	{
+		modify([](auto &values) { values.shrink_to_fit(); });
+	}
+
+	/// Are elements and their widths equal?
+	bool operator==(const packed_vector &other) const = default;
+
+	/// Get number of bytes, allocated for elements. 
+	/// Inline elements aren't counted
+	size_t memory_usage() const noexcept
+	{
+		return std::visit(
+			[](auto &values) { return values.memory_usage(); }, 
+			storage
+		);
+	}
+
+private:
+	/// Elements, stored with one of widths
+	std::variant<
+		elements<uint16_t>,
+		elements<uint32_t>,
+		elements<uint64_t>
+	> storage;
+
+	/// Call function with vector of elements
+	template<typename Function>
+	void modify(Function &&function)
+	{
+		switch (storage.index())
+		{
+			case 0: function(*std::get_if<0>(&storage)); break;
+			case 1: function(*std::get_if<1>(&storage)); break;
+			default: function(*std::get_if<2>(&storage)); break;
+		}
+	}
+
+	/// Widen elements, so that value fits
+	void fit(size_t value)
+	{
+		if (
+			storage.index() == 0 &&
+			value > std::numeric_limits<uint16_t>::max()
+		)
+		{
+			widen<uint32_t>();
+		}
+		if (
+			storage.index() == 1 &&
+			value > std::numeric_limits<uint32_t>::max()
+		)
+		{
+			widen<uint64_t>();
+		}
+	}
+
+	/// Convert elements to wider type
+	template<typename Wider>
+	void widen()
+	{
+		elements<Wider> wider(resource());
+		visit([&](auto values)
+		{
+			wider.reserve(values.size());
+			wider.assign(values.begin(), values.end());
+		});
+		storage = std::move(wider);
+	}
+};
+
+} // namespace unicode::utility
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
+
+namespace unicode::utility
+{
+
+/// Vector of trivially copyable elements,
+/// that stores up to Capacity of them inline, without allocation.
+/// Bigger vectors are allocated from polymorphic memory resource.
+/// Copies use default resource, like std::pmr containers
+template<typename T, size_t Capacity>
+class small_vector
+{
+	static_assert(
+		std::is_trivially_copyable_v<T>,
+		"elements are copied as bytes"
+	);
+
+public:
+	using value_type = T;
+	using allocator_type = std::pmr::polymorphic_allocator<T>;
+	using size_type = size_t;
+	using iterator = T *;
+	using const_iterator = const T *;
+
+	/// Empty vector
+	small_vector() noexcept = default;
+
+	/// Empty vector, that allocates memory with allocator
+	explicit small_vector(allocator_type allocator) noexcept
+		: allocator(allocator) {}
+
+	/// Copy elements, allocating memory from default resource
+	small_vector(const small_vector &other) { assign(other.begin(), other.end()); }
+
+	/// Copy elements, allocating memory with allocator
+	small_vector(const small_vector &other, allocator_type allocator)
+		: allocator(allocator)
+	{
+		assign(other.begin(), other.end());
+	}
+
+	/// Take elements and allocator of other vector
+	small_vector(small_vector &&other) noexcept : allocator(other.allocator)
+	{
+		take(other);
+	}
+
+	/// Copy elements, keeping allocator
+	small_vector &operator=(const small_vector &other)
+	{
+		if (this != &other) { assign(other.begin(), other.end()); }
+		return *this;
+	}
+
+	/// Take elements of other vector.
+	/// They are copied, if vectors have different allocators
+	small_vector &operator=(small_vector &&other)
+	{
+		if (this == &other) { return *this; }
+		if (allocator != other.allocator)
+		{
+			assign(other.begin(), other.end());
+			return *this;
+		}
+		deallocate();
+		take(other);
+		return *this;
+	}
+
+	~small_vector() { deallocate(); }
+
+	/// Get allocator of vector
+	allocator_type get_allocator() const noexcept { return allocator; }
+
+	/// Get pointer to elements
+	T *data() noexcept { return first; }
+	/// Get pointer to elements
+	const T *data() const noexcept { return first; }
+
+	iterator begin() noexcept { return first; }
+	const_iterator begin() const noexcept { return first; }
+	iterator end() noexcept { return first + count; }
+	const_iterator end() const noexcept { return first + count; }
+
+	/// Get number of elements
+	size_t size() const noexcept { return count; }
+
+	/// Get number of elements, that fit without reallocation
+	size_t capacity() const noexcept { return reserved; }
+
+	/// Is vector empty?
+	[[nodiscard]]
+	bool empty() const noexcept { return count == 0; }
+
+	/// Are elements stored inline?
+	bool is_inline() const noexcept { return first == local; }
+
+	/// Get element by index
+	T &operator[](size_t index) noexcept { return first[index]; }
+	/// Get element by index
+	const T &operator[](size_t index) const noexcept { return first[index]; }
+
+	/// Get last element
+	T &back() noexcept
+	{
+		assert(!empty() && "vector is empty");
+		return first[count - 1];
+	}
+	/// Get last element
+	const T &back() const noexcept
+	{
+		assert(!empty() && "vector is empty");
+		return first[count - 1];
+	}
+
+	/// Add element to the end of vector
+	void push_back(T value)
+	{
+		if (count == reserved) { grow(count + 1); }
+		first[count++] = value;
+	}
+
+	/// Remove last element
+	void pop_back() noexcept
+	{
+		assert(!empty() && "vector is empty");
+		--count;
+	}
+
+	/// Remove all elements, keeping memory
+	void clear() noexcept { count = 0; }
+
+	/// Change number of elements. New elements are zeroes
+	void resize(size_t size)
+	{
+		reserve(size);
+		if (size > count) { std::fill(first + count, first + size, T()); }
+		count = size;
+	}
+
+	/// Reserve memory for elements
+	void reserve(size_t capacity)
+	{
+		if (capacity > reserved) { reallocate(capacity); }
+	}
+
+	/// Free unused memory. Small vectors move back inline
+	void shrink_to_fit()
+	{
+		if (!is_inline() && count < reserved) { reallocate(count); }
+	}
+
+	/// Replace elements with values in range [from, to)
+	template<typename Iterator>
+	void assign(Iterator from, Iterator to)
+	{
+		auto size = size_t(std::distance(from, to));
+		count = 0;
+		reserve(size);
+		std::copy(from, to, first);
+		count = size;
+	}
+
+	/// Insert values in range [from, to) before position
+	template<typename Iterator>
+	iterator insert(const_iterator position, Iterator from, Iterator to)
+	{
+		auto index = size_t(position - first);
+		auto size = size_t(std::distance(from, to));
+		if (count + size > reserved) { grow(count + size); }
+
+		std::memmove(
+			first + index + size, first + index, (count - index) * sizeof(T)
+		);
+		std::copy(from, to, first + index);
+		count += size;
+		return first + index;
+	}
+
+	/// Remove elements in range [from, to)
+	iterator erase(const_iterator from, const_iterator to) noexcept
+	{
+		auto index = size_t(from - first);
+		auto size = size_t(to - from);
+		std::memmove(
+			first + index, first + index + size,
+			(count - index - size) * sizeof(T)
+		);
+		count -= size;
+		return first + index;
+	}
+
+	/// Are elements equal?
+	bool operator==(const small_vector &other) const noexcept
+	{
+		return std::equal(begin(), end(), other.begin(), other.end());
+	}
+
+	/// Get number of bytes, allocated for elements. Inline ones aren't counted
+	size_t memory_usage() const noexcept
+	{
+		return is_inline() ? 0 : reserved * sizeof(T);
+	}
+
+private:
+	/// Allocator of elements, that don't fit inline
+	allocator_type allocator;
+	/// Elements, that fit inline
+	T local[Capacity] = {};
+	/// Elements, either inline or allocated
+	T *first = local;
+	/// Number of elements
+	size_t count = 0;
+	/// Number of elements, that fit without reallocation
+	size_t reserved = Capacity;
+
+	/// Reallocate memory for at least capacity elements, growing geometrically
+	void grow(size_t capacity)
+	{
+		reallocate(std::max(capacity, 2 * reserved));
+	}
+
+	/// Move elements to memory for capacity elements.
+	/// Capacity, that fits inline, moves elements back inline
+	void reallocate(size_t capacity)
+	{
+		assert(capacity >= count && "elements don't fit");
+		auto elements =
+			capacity <= Capacity ? local : allocator.allocate(capacity);
+		if (elements == first) { return; }
+
+		std::memcpy(elements, first, count * sizeof(T));
+		deallocate();
+		first = elements;
+		reserved = std::max(capacity, Capacity);
+	}
+
+	/// Free allocated memory. Vector is inline after it
+	void deallocate() noexcept
+	{
+		if (!is_inline()) { allocator.deallocate(first, reserved); }
+		first = local;
+		reserved = Capacity;
+	}
+
+	/// Take elements of other vector with same allocator, leaving it empty
+	void take(small_vector &other) noexcept
+	{
+		if (other.is_inline())
+		{
+			// Whole buffer is copied, as its size is known at compile time
+			std::memcpy(local, other.local, sizeof(local));
+		}
+		else
+		{
+			first = other.first;
+			reserved = other.reserved;
+			other.first = other.local;
+			other.reserved = Capacity;
+		}
+		count = other.count;
+		other.count = 0;
+	}
+};
+
+} // namespace unicode::utility
@@ -0,0 +1,125 @@
+#include "unicode/algorithm.hpp"
+
+#include <cassert>
+
+#include "thread_pool.hpp"
+
+using namespace unicode;
+
+/// Get indexes of strings in ascending collation order, 
+/// computing and sorting keys on multiple threads. Order is stable
+std::vector<size_t> unicode::parallel_sorted_order(
+	std::span<const std::string_view> strings,
+	size_t threads
+)
+{
+	/// Minimal number of strings for a single task
+	constexpr size_t min_chunk_size = 256;
+	/// Number of tasks per thread. Extra tasks let threads balance load
+	constexpr size_t tasks_per_thread = 4;
+
+	auto &pool = utility::thread_pool::shared(threads);
+
+	size_t chunk_size = std::max(
+		min_chunk_size,
+		(strings.size() + pool.size() * tasks_per_thread - 1) / 
+			(pool.size() * tasks_per_thread)
+	);
+	size_t chunks = (strings.size() + chunk_size - 1) / chunk_size;
+	if (chunks <= 1)
+	{
+		return sort_keys(strings).order(/*stable*/true);
+	}
+
+	// Compute keys and sort each chunk
+	std::vector<sort_keys> keys(chunks);
+	std::vector<size_t> order(strings.size());
+	{
+		std::vector<utility::thread_pool::task> tasks;
+		for (size_t chunk = 0; chunk < chunks; ++chunk)
+		{
+			tasks.push_back(
+				[&, chunk]
+				{
+					auto first = chunk * chunk_size;
+					auto part = strings.subspan(
+						first, std::min(chunk_size, strings.size() - first)
+					);
+					keys[chunk] = sort_keys(part);
+
+					auto local = keys[chunk].order(/*stable*/true);
+					for (size_t i = 0; i < local.size(); ++i)
+					{
+						order[first + i] = first + local[i];
+					}
+				}
+			);
+		}
+		pool.run(std::move(tasks));
+	}
+
+	/// Compare strings by their keys
+	auto less = [&](size_t lhs, size_t rhs)
+	{
+		return sort_key::compare(
+			keys[lhs / chunk_size][lhs % chunk_size],
+			keys[rhs / chunk_size][rhs % chunk_size]
+		) < 0;
+	};
+
+	// Merge sorted runs pairwise, splitting big merges into independent parts
+	std::vector<size_t> buffer(strings.size());
+	for (size_t run = chunk_size; run < strings.size(); run *= 2)
+	{
+		size_t merges = (strings.size() + 2 * run - 1) / (2 * run);
+		size_t parts_per_merge = std::max<size_t>(
+			1, pool.size() * tasks_per_thread / merges
+		);
+
+		std::vector<utility::thread_pool::task> tasks;
+		for (size_t first = 0; first < strings.size(); first += 2 * run)
+		{
+			auto middle = std::min(first + run, strings.size());
+			auto last = std::min(first + 2 * run, strings.size());
+
+			auto left = order.begin() + first;
+			auto left_size = middle - first;
+			auto right = order.begin() + middle;
+			auto right_size = last - middle;
+
+			// Split left run evenly and find matching splits of right run.
+			// Equal elements of right run go after left ones to keep stability
+			auto split = [&, left, left_size, right, right_size](size_t part)
+			{
+				auto l = left_size * part / parts_per_merge;
+				if (part == 0) { return std::pair{l, size_t(0)}; }
+				if (l == left_size) { return std::pair{l, right_size}; }
+
+				auto r = std::lower_bound(
+					right, right + right_size, left[l], less
+				) - right;
+				return std::pair{l, size_t(r)};
+			};
+
+			for (size_t part = 0; part < parts_per_merge; ++part)
+			{
+				tasks.push_back(
+					[&, split, part, left, right, first]
+					{
+						auto [l_from, r_from] = split(part);
+						auto [l_to, r_to] = split(part + 1);
+						std::merge(
+							left + l_from, left + l_to,
+							right + r_from, right + r_to,
+							buffer.begin() + first + l_from + r_from,
+							less
+						);
+					}
+				);
+			}
+		}
+		pool.run(std::move(tasks));
+		order.swap(buffer);
+	}
+	return order;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define UNICODE_SSE2 1
+#endif
+
+namespace unicode::ascii
+{
+
+/// Find first byte that is not ASCII or is a carriage return.
+/// Each byte before it is a separate character, 
+/// if it's not followed by a non-ASCII byte
+inline const char *find_non_ascii_or_cr(
+	const char *first, 
+	const char *last
+) noexcept
+{
+#if defined(__AVX2__)
+	const __m256i cr = _mm256_set1_epi8('\r');
+	for (; last - first >= 32; first += 32)
+	{
+		auto bytes = _mm256_loadu_si256(
+			reinterpret_cast<const __m256i *>(first)
+		);
+		uint32_t mask = 
+			_mm256_movemask_epi8(bytes) | 
+			_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, cr));
+		if (mask) { return first + std::countr_zero(mask); }
+	}
+#elif defined(UNICODE_SSE2)
+	const __m128i cr = _mm_set1_epi8('\r');
+	for (; last - first >= 16; first += 16)
+	{
+		auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+		uint32_t mask = 
+			_mm_movemask_epi8(bytes) | 
+			_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, cr));
+		if (mask) { return first + std::countr_zero(mask); }
+	}
+#else
+	// Check 8 bytes at once
+	constexpr uint64_t ones = 0x0101010101010101;
+	constexpr uint64_t high_bits = 0x8080808080808080;
+	for (; last - first >= 8; first += 8)
+	{
+		uint64_t word;
+		std::memcpy(&word, first, sizeof(word));
+		auto cr = word ^ (ones * '\r');
+		if (((cr - ones) & ~cr & high_bits) | (word & high_bits)) { break; }
+	}
+#endif
+	while (first != last && uint8_t(*first) < 0x80 && *first != '\r')
+	{
+		++first;
+	}
+	return first;
+}
+
+} // namespace unicode::ascii
@@ -0,0 +1,85 @@
+#include "unicode/checkpoint_layout.hpp"
+
+#include <cassert>
+
+#include "runs.hpp"
+
+using namespace unicode;
+
+/// Get layout of string with checkpoint every interval characters
+checkpoint_layout checkpoint_layout::of(
+	std::string_view bytes, 
+	size_t interval
+)
+{
+	assert(interval != 0 && "interval must be positive");
+
+	checkpoint_layout layout;
+	layout.text = bytes;
+	layout.interval = interval;
+	if (bytes.empty()) { return layout; }
+
+	size_t characters = 0;
+	size_t byte_offset = 0;
+	auto next_checkpoint = interval;
+	grapheme::for_each_run(
+		bytes, 
+		[&](size_t character_size, size_t count)
+		{
+			for (; next_checkpoint < characters + count; next_checkpoint += interval)
+			{
+				layout.checkpoints.push_back(
+					byte_offset + (next_checkpoint - characters) * character_size
+				);
+			}
+			characters += count;
+			byte_offset += count * character_size;
+			return true;
+		}
+	);
+	layout.character_count = characters;
+	layout.checkpoints.push_back(bytes.size());
+	layout.checkpoints.shrink_to_fit();
+	return layout;
+}
+
+/// Segment block from character at byte offset 
+/// until run, containing character, is found
+run checkpoint_layout::find_run(
+	size_t block_index,
+	size_t first,
+	size_t byte_offset,
+	size_t character_index
+) const noexcept
+{
+	assert(first <= character_index && "segmentation starts after character");
+
+	auto block_end = checkpoints[block_index + 1];
+	unicode::run result{block_index, first, first, byte_offset, 0};
+	grapheme::for_each_run(
+		text.substr(byte_offset, block_end - byte_offset),
+		[&](size_t character_size, size_t count)
+		{
+			if (count == 0) { return true; }
+			if (character_size != result.character_size)
+			{
+				// Run, containing character, is complete
+				if (result.last > character_index) { return false; }
+				result = {
+					block_index, 
+					result.last, 
+					result.last, 
+					result.byte_end(), 
+					character_size
+				};
+			}
+			result.last += count;
+			return true;
+		}
+	);
+	assert(
+		result.first <= character_index && character_index < result.last &&
+		"character not found"
+	);
+	return result;
+}
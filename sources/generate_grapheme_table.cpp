@@ -0,0 +1,165 @@
+/// Generates tables of grapheme cluster break properties 
+/// from Unicode Character Database, that is shipped with ICU.
+/// Usage: generate_grapheme_table <output header>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include <unicode/uchar.h>
+#include <unicode/uscript.h>
+#include <unicode/uversion.h>
+
+#include "grapheme.hpp"
+
+using namespace unicode::grapheme;
+
+/// Number of bits of code point, that index inside of a table block
+constexpr unsigned shift = 7;
+/// Number of code points in a table block
+constexpr size_t block_size = 1 << shift;
+
+/// Convert ICU Grapheme_Cluster_Break property
+static category toCategory(int32_t gcb)
+{
+	switch (gcb)
+	{
+	case U_GCB_CR: return category::cr;
+	case U_GCB_LF: return category::lf;
+	case U_GCB_CONTROL: return category::control;
+	case U_GCB_EXTEND: return category::extend;
+	case U_GCB_ZWJ: return category::zwj;
+	case U_GCB_REGIONAL_INDICATOR: return category::regional_indicator;
+	case U_GCB_PREPEND: return category::prepend;
+	case U_GCB_SPACING_MARK: return category::spacing_mark;
+	case U_GCB_L: return category::l;
+	case U_GCB_V: return category::v;
+	case U_GCB_T: return category::t;
+	case U_GCB_LV: return category::lv;
+	case U_GCB_LVT: return category::lvt;
+	default: return category::other;
+	}
+}
+
+/// Get Indic_Conjunct_Break property.
+/// ICU 76+ provides it. Earlier versions apply rule GB9c as a tailoring,
+/// so the property is derived the same way: consonants and viramas 
+/// of scripts, that link conjuncts, and combining marks with ZWJ
+static conjunct toConjunct(UChar32 code_point)
+{
+#if U_ICU_VERSION_MAJOR_NUM >= 76
+	switch (u_getIntPropertyValue(code_point, UCHAR_INDIC_CONJUNCT_BREAK))
+	{
+	case U_INCB_CONSONANT: return conjunct::consonant;
+	case U_INCB_EXTEND: return conjunct::extend;
+	case U_INCB_LINKER: return conjunct::linker;
+	default: return conjunct::none;
+	}
+#else
+	auto script = u_getIntPropertyValue(code_point, UCHAR_SCRIPT);
+	bool is_linking_script = 
+		script == USCRIPT_DEVANAGARI || 
+		script == USCRIPT_BENGALI || 
+		script == USCRIPT_GUJARATI ||
+		script == USCRIPT_ORIYA || 
+		script == USCRIPT_TELUGU || 
+		script == USCRIPT_MALAYALAM;
+	auto syllabic = 
+		u_getIntPropertyValue(code_point, UCHAR_INDIC_SYLLABIC_CATEGORY);
+	if (is_linking_script && syllabic == U_INSC_CONSONANT) 
+	{ 
+		return conjunct::consonant; 
+	}
+	if (is_linking_script && syllabic == U_INSC_VIRAMA) 
+	{ 
+		return conjunct::linker; 
+	}
+
+	auto gcb = u_getIntPropertyValue(code_point, UCHAR_GRAPHEME_CLUSTER_BREAK);
+	if (
+		gcb == U_GCB_ZWJ || 
+		(gcb == U_GCB_EXTEND && u_getCombiningClass(code_point) != 0)
+	)
+	{
+		return conjunct::extend;
+	}
+	return conjunct::none;
+#endif
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 2)
+	{
+		std::fprintf(stderr, "Usage: %s <output header>\n", argv[0]);
+		return 1;
+	}
+
+	// Split properties of all code points into deduplicated blocks
+	std::vector<uint16_t> index;
+	std::vector<uint8_t> blocks;
+	std::map<std::vector<uint8_t>, uint16_t> known;
+	for (UChar32 first = 0; first <= UCHAR_MAX_VALUE; first += block_size)
+	{
+		std::vector<uint8_t> block;
+		for (
+			auto code_point = first; 
+			code_point < first + UChar32(block_size); 
+			++code_point
+		)
+		{
+			properties props{
+				toCategory(
+					u_getIntPropertyValue(
+						code_point, UCHAR_GRAPHEME_CLUSTER_BREAK
+					)
+				),
+				bool(
+					u_hasBinaryProperty(
+						code_point, UCHAR_EXTENDED_PICTOGRAPHIC
+					)
+				),
+				toConjunct(code_point)
+			};
+			block.push_back(props.bits);
+		}
+
+		auto [it, inserted] = known.emplace(block, known.size());
+		if (inserted) { blocks.insert(blocks.end(), block.begin(), block.end()); }
+		index.push_back(it->second);
+	}
+
+	std::ofstream out(argv[1]);
+	if (!out)
+	{
+		std::fprintf(stderr, "Can't open %s\n", argv[1]);
+		return 1;
+	}
+
+	out << 
+		"// Generated by generate_grapheme_table from ICU " 
+			U_ICU_VERSION " (Unicode " U_UNICODE_VERSION "). Do not edit\n"
+		"#pragma once\n\n"
+		"#include <cstdint>\n\n"
+		"namespace unicode::grapheme::table\n{\n\n"
+		"/// Number of bits of code point, that index inside of a block\n"
+		"constexpr unsigned shift = " << shift << ";\n\n"
+		"/// Index of block for each range of code points\n"
+		"constexpr " << (known.size() <= 256 ? "uint8_t" : "uint16_t") << 
+			" index[] = {";
+	for (size_t i = 0; i < index.size(); ++i)
+	{
+		out << (i % 16 == 0 ? "\n\t" : " ") << index[i] << ',';
+	}
+	out << 
+		"\n};\n\n"
+		"/// Packed properties of code points in blocks\n"
+		"constexpr uint8_t properties[] = {";
+	for (size_t i = 0; i < blocks.size(); ++i)
+	{
+		out << (i % 16 == 0 ? "\n\t" : " ") << unsigned(blocks[i]) << ',';
+	}
+	out << "\n};\n\n} // namespace unicode::grapheme::table\n";
+	return out ? 0 : 1;
+}
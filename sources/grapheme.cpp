@@ -0,0 +1,65 @@
+#include "grapheme.hpp"
+
+#include "grapheme_table.hpp"
+
+using namespace unicode::grapheme;
+
+/// Get properties of code point
+properties unicode::grapheme::properties_of(char32_t code_point) noexcept
+{
+	if (code_point > 0x10FFFF) { return {}; }
+
+	constexpr char32_t mask = (1 << table::shift) - 1;
+	auto block = table::index[code_point >> table::shift];
+	return properties::from_bits(
+		table::properties[(size_t(block) << table::shift) | (code_point & mask)]
+	);
+}
+
+/// Get offset of the next boundary
+size_t segmenter::next() noexcept
+{
+	if (offset >= bytes.size()) { return npos; }
+
+	auto first = bytes.data();
+	auto size = bytes.size();
+	auto last = first + size;
+
+	auto current = offset + consumed;
+	if (consumed == 0)
+	{
+		auto decoded = decode(first + offset, last);
+		automaton::is_break(state, properties_of(decoded.code_point));
+		current += decoded.size;
+	}
+
+	while (current < size)
+	{
+		// ASCII character after ASCII character, other than CR, 
+		// always starts a new cluster
+		if (
+			uint8_t(first[current]) < 0x80 &&
+			uint8_t(first[current - 1]) < 0x80 && first[current - 1] != '\r'
+		)
+		{
+			state = automaton::transitions[automaton::start][
+				automaton::ascii_properties(first[current]).bits
+			] & ~automaton::break_bit;
+			offset = current;
+			consumed = 1;
+			return offset;
+		}
+
+		auto decoded = decode(first + current, last);
+		if (automaton::is_break(state, properties_of(decoded.code_point)))
+		{
+			offset = current;
+			consumed = decoded.size;
+			return offset;
+		}
+		current += decoded.size;
+	}
+
+	offset = size;
+	return offset;
+}
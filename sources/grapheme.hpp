@@ -0,0 +1,428 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/// Extended grapheme cluster segmentation (UAX #29) over UTF-8
+namespace unicode::grapheme
+{
+
+/// Grapheme_Cluster_Break property of code point
+enum class category : uint8_t
+{
+	other,
+	cr,
+	lf,
+	control,
+	extend,
+	zwj,
+	regional_indicator,
+	prepend,
+	spacing_mark,
+	l,
+	v,
+	t,
+	lv,
+	lvt,
+	count
+};
+
+/// Indic_Conjunct_Break property of code point
+enum class conjunct : uint8_t
+{
+	none,
+	consonant,
+	extend,
+	linker
+};
+
+/// Properties of code point, that matter for segmentation, packed in a byte
+class properties
+{
+public:
+	/// Pack properties
+	constexpr properties(
+		grapheme::category category = category::other,
+		bool extended_pictographic = false,
+		grapheme::conjunct conjunct = conjunct::none
+	) noexcept
+		: bits(
+			uint8_t(category) |
+			(extended_pictographic << 4) |
+			(uint8_t(conjunct) << 5)
+		)
+	{}
+
+	/// Unpack properties from byte
+	static constexpr properties from_bits(uint8_t bits) noexcept
+	{
+		properties props;
+		props.bits = bits;
+		return props;
+	}
+
+	/// Get Grapheme_Cluster_Break property
+	constexpr grapheme::category category() const noexcept
+	{
+		return grapheme::category(bits & 0x0F);
+	}
+	/// Get Extended_Pictographic property
+	constexpr bool extended_pictographic() const noexcept
+	{
+		return bits & 0x10;
+	}
+	/// Get Indic_Conjunct_Break property
+	constexpr grapheme::conjunct conjunct() const noexcept
+	{
+		return grapheme::conjunct(bits >> 5);
+	}
+
+	/// Packed properties
+	uint8_t bits = 0;
+};
+
+/// Get properties of code point
+properties properties_of(char32_t code_point) noexcept;
+
+/// Code point decoded from UTF-8
+struct decoded
+{
+	/// Code point. U+FFFD for ill-formed sequences
+	char32_t code_point = 0;
+	/// Number of bytes. Ill-formed sequences take their maximal subpart
+	size_t size = 0;
+};
+
+/// Decode code point at the beginning of non-empty UTF-8 sequence
+inline decoded decode(const char *first, const char *last) noexcept
+{
+	auto byte = [&](ptrdiff_t i) -> uint8_t { return uint8_t(first[i]); };
+	auto available = last - first;
+
+	auto lead = byte(0);
+	if (lead < 0x80) { return {lead, 1}; }
+
+	// Number of trail bytes and range of the first one
+	size_t trails = 0;
+	uint8_t low = 0x80, high = 0xBF;
+	char32_t code_point = 0;
+	if (lead >= 0xC2 && lead <= 0xDF)
+	{
+		trails = 1;
+		code_point = lead & 0x1F;
+	}
+	else if (lead >= 0xE0 && lead <= 0xEF)
+	{
+		trails = 2;
+		code_point = lead & 0x0F;
+		if (lead == 0xE0) { low = 0xA0; }
+		else if (lead == 0xED) { high = 0x9F; }
+	}
+	else if (lead >= 0xF0 && lead <= 0xF4)
+	{
+		trails = 3;
+		code_point = lead & 0x07;
+		if (lead == 0xF0) { low = 0x90; }
+		else if (lead == 0xF4) { high = 0x8F; }
+	}
+	else { return {0xFFFD, 1}; }
+
+	for (size_t i = 1; i <= trails; ++i)
+	{
+		if (ptrdiff_t(i) >= available) { return {0xFFFD, i}; }
+
+		auto trail = byte(i);
+		if (trail < low || trail > high) { return {0xFFFD, i}; }
+		code_point = (code_point << 6) | (trail & 0x3F);
+		low = 0x80;
+		high = 0xBF;
+	}
+	return {code_point, trails + 1};
+}
+
+/// Result of rules, that depend only on pair of categories
+enum class pair_rule : uint8_t
+{
+	/// Break, no matter what was before
+	must_break,
+	/// Break, unless rules for emoji, flags or conjuncts apply
+	may_break,
+	/// No break
+	no_break
+};
+
+/// Apply rules GB3-GB9b and GB999 to pair of categories
+constexpr pair_rule apply_pair_rules(category previous, category next) noexcept
+{
+	using enum category;
+
+	// GB3
+	if (previous == cr && next == lf) { return pair_rule::no_break; }
+	// GB4
+	if (previous == cr || previous == lf || previous == control) 
+	{ 
+		return pair_rule::must_break; 
+	}
+	// GB5
+	if (next == cr || next == lf || next == control) 
+	{ 
+		return pair_rule::must_break; 
+	}
+	// GB6
+	if (previous == l && (next == l || next == v || next == lv || next == lvt))
+	{
+		return pair_rule::no_break;
+	}
+	// GB7
+	if ((previous == lv || previous == v) && (next == v || next == t))
+	{
+		return pair_rule::no_break;
+	}
+	// GB8
+	if ((previous == lvt || previous == t) && next == t)
+	{
+		return pair_rule::no_break;
+	}
+	// GB9, GB9a
+	if (next == extend || next == zwj || next == spacing_mark)
+	{
+		return pair_rule::no_break;
+	}
+	// GB9b
+	if (previous == prepend) { return pair_rule::no_break; }
+	// GB999
+	return pair_rule::may_break;
+}
+
+/// Pair rules for each pair of categories
+constexpr auto pair_rules = []
+{
+	constexpr size_t categories = size_t(category::count);
+
+	std::array<std::array<pair_rule, categories>, categories> table{};
+	for (size_t previous = 0; previous < categories; ++previous)
+	{
+		for (size_t next = 0; next < categories; ++next)
+		{
+			table[previous][next] = 
+				apply_pair_rules(category(previous), category(next));
+		}
+	}
+	return table;
+}();
+
+/// State of segmentation rules between two code points
+class rules
+{
+public:
+	/// Is there a boundary before the next code point?
+	/// Moves state past it
+	constexpr bool is_break(properties next) noexcept
+	{
+		auto next_category = next.category();
+		auto rule = pair_rules[size_t(previous)][size_t(next_category)];
+
+		bool result = rule == pair_rule::must_break;
+		if (rule == pair_rule::may_break)
+		{
+			// GB9c
+			bool conjunct = 
+				consonant == 2 && next.conjunct() == conjunct::consonant;
+			// GB11
+			bool emoji_sequence = 
+				previous == category::zwj && 
+				emoji == 2 && 
+				next.extended_pictographic();
+			// GB12, GB13
+			bool flag = 
+				previous == category::regional_indicator && 
+				next_category == category::regional_indicator &&
+				odd_regional_indicators;
+			result = !(conjunct || emoji_sequence || flag);
+		}
+
+		advance(next);
+		return result;
+	}
+
+	/// Get unique number of state
+	constexpr size_t key() const noexcept
+	{
+		return 
+			((size_t(previous) * 3 + emoji) * 2 + odd_regional_indicators) * 3 + 
+			consonant;
+	}
+
+	/// Number of distinct keys
+	static constexpr size_t keys = size_t(category::count) * 3 * 2 * 3;
+
+private:
+	/// Category of previous code point.
+	/// Start of text acts like control: there is always a break after it
+	category previous = category::control;
+	/// Has Extended_Pictographic Extend* been seen (1) and followed by ZWJ (2)?
+	uint8_t emoji = 0;
+	/// Is number of consecutive regional indicators odd?
+	bool odd_regional_indicators = false;
+	/// Has conjunct consonant been seen (1) and followed by linker (2)?
+	uint8_t consonant = 0;
+
+	/// Move state past next code point
+	constexpr void advance(properties next) noexcept
+	{
+		auto next_category = next.category();
+
+		if (next.extended_pictographic()) { emoji = 1; }
+		else if (emoji == 1 && next_category == category::zwj) { emoji = 2; }
+		else if (!(emoji == 1 && next_category == category::extend)) 
+		{ 
+			emoji = 0; 
+		}
+
+		odd_regional_indicators = 
+			next_category == category::regional_indicator && 
+			!odd_regional_indicators;
+
+		auto conjunct = next.conjunct();
+		if (conjunct == conjunct::consonant) { consonant = 1; }
+		else if (conjunct == conjunct::linker) 
+		{ 
+			if (consonant != 0) { consonant = 2; } 
+		}
+		else if (conjunct == conjunct::none) { consonant = 0; }
+
+		previous = next_category;
+	}
+};
+
+/// Deterministic finite automaton, equivalent to segmentation rules.
+/// Its state is a byte, transitions are indexed by packed properties
+namespace automaton
+{
+
+/// Number of distinct packed properties
+constexpr size_t inputs = 128;
+/// Set in transition, if there is a break before code point
+constexpr uint8_t break_bit = 0x80;
+/// State at the start of text
+constexpr uint8_t start = 0;
+
+/// Get properties by input of automaton
+constexpr properties input(size_t bits) noexcept
+{
+	auto props = properties::from_bits(uint8_t(bits));
+	if (props.category() >= category::count) { return {}; }
+	return props;
+}
+
+/// States of rules, reachable from the start of text
+struct reachable
+{
+	/// States in order of discovery
+	std::array<rules, rules::keys> states{};
+	/// Number of states
+	size_t count = 0;
+	/// Index of state by its key, plus one. Zero for unknown states
+	std::array<size_t, rules::keys> indexes{};
+
+	/// Get index of state, adding it if it's new
+	constexpr size_t index_of(const rules &state) noexcept
+	{
+		auto &index = indexes[state.key()];
+		if (index == 0)
+		{
+			states[count] = state;
+			index = ++count;
+		}
+		return index - 1;
+	}
+};
+
+/// Find all states of rules, reachable from the start of text
+constexpr reachable find_reachable() noexcept
+{
+	reachable result;
+	result.index_of(rules{});
+	for (size_t i = 0; i < result.count; ++i)
+	{
+		for (size_t bits = 0; bits < inputs; ++bits)
+		{
+			auto state = result.states[i];
+			state.is_break(input(bits));
+			result.index_of(state);
+		}
+	}
+	return result;
+}
+
+/// Number of states
+constexpr size_t states = find_reachable().count;
+static_assert(states < break_bit, "too many states");
+
+/// Transitions between states
+constexpr auto transitions = []
+{
+	auto reachable = find_reachable();
+
+	std::array<std::array<uint8_t, inputs>, states> table{};
+	for (size_t i = 0; i < states; ++i)
+	{
+		for (size_t bits = 0; bits < inputs; ++bits)
+		{
+			auto state = reachable.states[i];
+			bool is_break = state.is_break(input(bits));
+			table[i][bits] = 
+				uint8_t(reachable.index_of(state)) | 
+				(is_break ? break_bit : 0);
+		}
+	}
+	return table;
+}();
+
+/// Is there a boundary before the next code point?
+/// Moves state past it
+inline bool is_break(uint8_t &state, properties next) noexcept
+{
+	auto transition = transitions[state][next.bits];
+	state = transition & ~break_bit;
+	return transition & break_bit;
+}
+
+/// Get properties of ASCII character
+constexpr properties ascii_properties(char c) noexcept
+{
+	if (c == '\r') { return category::cr; }
+	if (c == '\n') { return category::lf; }
+	if (uint8_t(c) < 0x20 || c == 0x7F) { return category::control; }
+	return category::other;
+}
+
+} // namespace automaton
+
+/// Segmenter of UTF-8 text into extended grapheme clusters
+class segmenter
+{
+public:
+	/// Segment text, starting at a cluster boundary
+	explicit segmenter(std::string_view bytes) noexcept : bytes(bytes) {}
+
+	/// Get offset of the next boundary. Returns npos at the end of text
+	size_t next() noexcept;
+
+	/// No more boundaries
+	static constexpr size_t npos = std::string_view::npos;
+
+private:
+	/// Text to segment
+	std::string_view bytes;
+	/// Offset of current boundary
+	size_t offset = 0;
+	/// Size of code point after current boundary, if automaton moved past it
+	size_t consumed = 0;
+	/// State of automaton
+	uint8_t state = automaton::start;
+};
+
+} // namespace unicode::grapheme
@@ -0,0 +1,150 @@
+#include "unicode/grapheme_stream.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "grapheme.hpp"
+
+using namespace unicode;
+
+static_assert(grapheme::automaton::start == 0, "stream starts with zero state");
+
+namespace
+{
+
+/// Get number of bytes in well-formed sequence with lead byte
+size_t sequence_size(char lead) noexcept
+{
+	auto byte = uint8_t(lead);
+	if (byte >= 0xC2 && byte <= 0xDF) { return 2; }
+	if (byte >= 0xE0 && byte <= 0xEF) { return 3; }
+	if (byte >= 0xF0 && byte <= 0xF4) { return 4; }
+	return 1;
+}
+
+/// Is decoded code point a prefix of well-formed sequence, 
+/// cut by the end of available bytes?
+bool is_cut(
+	const char *first, 
+	size_t available, 
+	grapheme::decoded decoded
+) noexcept
+{
+	return decoded.size == available && sequence_size(*first) > available;
+}
+
+} // namespace
+
+/// Segment next chunk of text
+void grapheme_stream::push(std::string_view chunk, callback emit)
+{
+	using namespace grapheme;
+
+	auto first = chunk.data();
+	auto last = first + chunk.size();
+	// Offset of the next code point in chunk
+	size_t current = 0;
+
+	// Complete code point, split between chunks
+	if (incomplete != 0)
+	{
+		std::array<char, 4> buffer;
+		auto taken = std::min(chunk.size(), buffer.size() - incomplete);
+		auto start = pending.size() - incomplete;
+		std::copy_n(pending.data() + start, incomplete, buffer.data());
+		std::copy_n(first, taken, buffer.data() + incomplete);
+
+		auto available = incomplete + taken;
+		auto decoded = decode(buffer.data(), buffer.data() + available);
+		if (is_cut(buffer.data(), available, decoded))
+		{
+			pending.append(chunk);
+			incomplete = available;
+			return;
+		}
+
+		if (automaton::is_break(state, properties_of(decoded.code_point)))
+		{
+			if (start != 0) 
+			{ 
+				emit(character_view(std::string_view(pending).substr(0, start))); 
+			}
+			pending.erase(0, start);
+		}
+		current = decoded.size - incomplete;
+		pending.append(chunk.substr(0, current));
+		incomplete = 0;
+	}
+
+	// Start of unfinished character in chunk, 
+	// if it doesn't start in pending bytes
+	auto start = current;
+	auto complete = [&]
+	{
+		if (!pending.empty())
+		{
+			pending.append(chunk.substr(start, current - start));
+			emit(character_view(pending));
+			pending.clear();
+		}
+		else if (current != start)
+		{
+			emit(character_view(chunk.substr(start, current - start)));
+		}
+		start = current;
+	};
+	while (current < chunk.size())
+	{
+		// ASCII character after ASCII character, other than CR, 
+		// always starts a new character
+		if (
+			current != 0 &&
+			uint8_t(first[current]) < 0x80 &&
+			uint8_t(first[current - 1]) < 0x80 && first[current - 1] != '\r'
+		)
+		{
+			state = automaton::transitions[automaton::start][
+				automaton::ascii_properties(first[current]).bits
+			] & ~automaton::break_bit;
+			complete();
+			++current;
+			continue;
+		}
+
+		auto decoded = decode(first + current, last);
+		if (is_cut(first + current, chunk.size() - current, decoded))
+		{
+			incomplete = chunk.size() - current;
+			break;
+		}
+		if (automaton::is_break(state, properties_of(decoded.code_point)))
+		{
+			complete();
+		}
+		current += decoded.size;
+	}
+	pending.append(chunk.substr(start));
+}
+
+/// End of text
+void grapheme_stream::finish(callback emit)
+{
+	using namespace grapheme;
+
+	// Incomplete code point is ill-formed
+	if (
+		incomplete != 0 && 
+		automaton::is_break(state, properties_of(0xFFFD)) &&
+		pending.size() != incomplete
+	)
+	{
+		auto start = pending.size() - incomplete;
+		emit(character_view(std::string_view(pending).substr(0, start)));
+		pending.erase(0, start);
+	}
+	if (!pending.empty()) { emit(character_view(pending)); }
+
+	pending.clear();
+	incomplete = 0;
+	state = automaton::start;
+}
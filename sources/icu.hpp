@@ -1,27 +1,85 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <iterator>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <unicode/utext.h>
 #include <unicode/brkiter.h>
+#include <unicode/coll.h>
+#include <unicode/ustring.h>
 
-/// Get character break iterator at the beginning of openned unicode text 
+/// Factory of break iterators, e.g. icu::BreakIterator::createWordInstance
+using BreakIteratorFactory = 
+	icu::BreakIterator *(*)(const icu::Locale &, UErrorCode &);
+
+/// Break iterators of factory, cached per thread
+struct BreakIteratorCache
+{
+	/// Factory of iterators
+	BreakIteratorFactory create = nullptr;
+	/// Name of locale of iterators
+	std::string localeName;
+	/// Iterator, that is copied instead of creating new ones.
+	/// Creating iterator loads its rules, copying doesn't
+	std::unique_ptr<icu::BreakIterator> prototype;
+	/// Iterator, that is moved to each new text
+	std::unique_ptr<icu::BreakIterator> reused;
+};
+
+/// Get break iterators of factory for default locale, cached per thread.
+/// They are recreated only if default locale changes
+inline BreakIteratorCache &
+getBreakIteratorCache(BreakIteratorFactory create) noexcept
+{
+	thread_local std::vector<BreakIteratorCache> caches;
+
+	auto cache = std::find_if(
+		caches.begin(), caches.end(),
+		[create](const BreakIteratorCache &cache) 
+		{ 
+			return cache.create == create; 
+		}
+	);
+	if (cache == caches.end())
+	{
+		caches.emplace_back().create = create;
+		cache = std::prev(caches.end());
+	}
+
+	auto &locale = icu::Locale::getDefault();
+	if (!cache->prototype || cache->localeName != locale.getName())
+	{
+		UErrorCode errorCode = U_ZERO_ERROR;
+		cache->prototype.reset(create(locale, errorCode));
+		if (U_FAILURE(errorCode)) 
+		{ 
+			cache->prototype = nullptr; 
+		}
+		cache->reused = nullptr;
+		cache->localeName = locale.getName();
+	}
+	return *cache;
+}
+
+/// Get break iterator, created by factory, 
+/// at the beginning of openned unicode text.
+/// Iterator is copied from prototype, cached per thread
 inline std::unique_ptr<icu::BreakIterator> 
-getCharacterBreakIterator(UText *utext) noexcept
+getBreakIterator(UText *utext, BreakIteratorFactory create) noexcept
 {
-	UErrorCode errorCode = U_ZERO_ERROR;
-	std::unique_ptr<icu::BreakIterator> it {
-		icu::BreakIterator::createCharacterInstance(
-			icu::Locale::getDefault(), 
-			errorCode
-		)
-	};
-	if (U_FAILURE(errorCode))
+	auto &cache = getBreakIteratorCache(create);
+	if (!cache.prototype)
 	{
 		return nullptr;
 	}
 
-	errorCode = U_ZERO_ERROR;
+	std::unique_ptr<icu::BreakIterator> it{cache.prototype->clone()};
+	UErrorCode errorCode = U_ZERO_ERROR;
 	it->setText(utext, errorCode);
 	if (U_FAILURE(errorCode))
 	{
@@ -30,6 +88,43 @@ getCharacterBreakIterator(UText *utext) noexcept
 	return it;
 }
 
+/// Get break iterator, created by factory, 
+/// at the beginning of openned unicode text.
+/// Iterator is cached per thread and only moved to new text,
+/// so it's valid until the next call with same factory on this thread.
+/// Returns nullptr on failure
+inline icu::BreakIterator *
+getCachedBreakIterator(UText *utext, BreakIteratorFactory create) noexcept
+{
+	auto &cache = getBreakIteratorCache(create);
+	if (!cache.prototype)
+	{
+		return nullptr;
+	}
+	if (!cache.reused)
+	{
+		cache.reused.reset(cache.prototype->clone());
+	}
+
+	UErrorCode errorCode = U_ZERO_ERROR;
+	cache.reused->setText(utext, errorCode);
+	if (U_FAILURE(errorCode))
+	{
+		return nullptr;
+	}
+	return cache.reused.get();
+}
+
+/// Get character break iterator at the beginning of openned unicode text 
+inline std::unique_ptr<icu::BreakIterator> 
+getCharacterBreakIterator(UText *utext) noexcept
+{
+	return getBreakIterator(
+		utext, 
+		icu::BreakIterator::createCharacterInstance
+	);
+}
+
 /// Open utf-8 string as unicode text
 inline auto openUText(std::string_view str) noexcept
 {
@@ -50,4 +145,109 @@ inline auto openUText(std::string_view str) noexcept
 		utext = nullptr;
 	}
 	return utext;
+}
+
+/// Unicode text, stored in place, e.g. on stack or in thread-local variable.
+/// Reopening it reuses its buffers, so it doesn't allocate
+class LocalUText
+{
+public:
+	LocalUText() = default;
+	LocalUText(const LocalUText &) = delete;
+	LocalUText &operator=(const LocalUText &) = delete;
+
+	/// Close text
+	~LocalUText() { utext_close(&utext); }
+
+	/// Open utf-8 string as unicode text. Returns nullptr on failure
+	UText *open(std::string_view str) noexcept
+	{
+		UErrorCode errorCode = U_ZERO_ERROR;
+		utext_openUTF8(&utext, str.data(), str.size(), &errorCode);
+		if (U_FAILURE(errorCode))
+		{
+			return nullptr;
+		}
+		return &utext;
+	}
+
+private:
+	/// Text, which is opened in place
+	UText utext = UTEXT_INITIALIZER;
+};
+
+/// Create collator for locale. Returns nullptr on failure
+inline std::unique_ptr<icu::Collator> 
+createCollator(const icu::Locale &locale) noexcept
+{
+	UErrorCode errorCode = U_ZERO_ERROR;
+	std::unique_ptr<icu::Collator> collator{
+		icu::Collator::createInstance(locale, errorCode)
+	};
+	if (U_FAILURE(errorCode))
+	{
+		return nullptr;
+	}
+	return collator;
+}
+
+/// Get collator for default locale. 
+/// Collator is cached per thread and recreated only if default locale changes
+inline const icu::Collator *getDefaultCollator() noexcept
+{
+	thread_local std::unique_ptr<icu::Collator> collator;
+	thread_local std::string localeName;
+
+	auto &locale = icu::Locale::getDefault();
+	if (!collator || localeName != locale.getName())
+	{
+		collator = createCollator(locale);
+		localeName = locale.getName();
+	}
+	return collator.get();
+}
+
+/// Append collation key of UTF-8 string to the end of buffer.
+/// Falls back to raw bytes, if there is no collator
+inline void appendSortKey(
+	const icu::Collator *collator,
+	std::string_view str,
+	std::vector<uint8_t> &buffer
+)
+{
+	if (!collator)
+	{
+		buffer.insert(buffer.end(), str.begin(), str.end());
+		return;
+	}
+
+	// Reuse UTF-16 buffer to avoid allocations for each key
+	thread_local std::u16string utf16;
+	utf16.resize(str.size() + 1);
+
+	int32_t length = 0;
+	UErrorCode errorCode = U_ZERO_ERROR;
+	u_strFromUTF8WithSub(
+		utf16.data(), int32_t(utf16.size()), &length, 
+		str.data(), int32_t(str.size()), 
+		0xFFFD, nullptr, 
+		&errorCode
+	);
+	assert(U_SUCCESS(errorCode) && "invalid conversion to UTF-16");
+
+	auto start = buffer.size();
+	buffer.resize(start + std::max<size_t>(2 * length + 16, 32));
+	auto size = collator->getSortKey(
+		utf16.data(), length, 
+		buffer.data() + start, int32_t(buffer.size() - start)
+	);
+	if (size_t(size) > buffer.size() - start)
+	{
+		buffer.resize(start + size);
+		collator->getSortKey(
+			utf16.data(), length, 
+			buffer.data() + start, size
+		);
+	}
+	buffer.resize(start + size);
 }
\ No newline at end of file
@@ -1,46 +1,595 @@
 #include "unicode/layout.hpp"
 
+#include <algorithm>
 #include <cassert>
 
-#include "icu.hpp"
+#include "runs.hpp"
+#include "thread_pool.hpp"
 
 using namespace unicode;
 
-/// Get layout of string
-layout layout::of(std::string_view bytes) noexcept
+namespace
 {
-	if (bytes.empty()) { return {}; }
 
-	layout layout;
+/// Scratch buffers for more runs are freed after use, 
+/// smaller ones are kept, so that short strings don't allocate
+constexpr size_t max_scratch_runs = 1 << 16;
 
-	auto utext = openUText(bytes);
-	assert(utext);
+/// Columns of blocks before packing
+struct columns
+{
+	/// Character offsets of blocks, followed by number of characters
+	std::vector<size_t> offsets;
+	/// Byte offsets of runs or indexes of chunks, followed by number of bytes
+	std::vector<size_t> byte_offsets;
+	/// Sizes of characters in runs. 0 for chunks
+	std::vector<uint8_t> sizes;
+	/// Byte offsets of chunks
+	std::vector<size_t> bases;
+	/// Indexes of the first delta of chunks
+	std::vector<size_t> starts;
+	/// Byte offsets of characters inside of chunks, relative to base
+	std::vector<uint8_t> deltas;
+
+	/// Remove all blocks, keeping memory
+	void clear() noexcept
+	{
+		offsets.clear();
+		byte_offsets.clear();
+		sizes.clear();
+		bases.clear();
+		starts.clear();
+		deltas.clear();
+	}
+
+	/// Free memory, if it's too big to keep for reuse
+	void trim() noexcept
+	{
+		if (offsets.capacity() > max_scratch_runs) { *this = {}; }
+	}
+};
+
+/// Store runs of characters in empty blocks, 
+/// compacting fragmented runs in chunks.
+/// Offsets of runs are followed by number of characters and bytes.
+/// Size 0 marks characters bigger than max_character_size
+void compact(
+	std::span<const size_t> run_offsets,
+	std::span<const size_t> run_byte_offsets,
+	std::span<const uint8_t> run_sizes,
+	columns &blocks
+)
+{
+	constexpr auto chunk_capacity = layout_blocks::chunk_capacity;
+	constexpr auto min_block_characters = layout_blocks::min_block_characters;
+	constexpr auto min_fragmented_blocks = layout_blocks::min_fragmented_blocks;
+
+	auto runs = run_sizes.size();
+	assert(
+		run_offsets.size() == runs + 1 &&
+		run_byte_offsets.size() == runs + 1 &&
+		"wrong number of offsets"
+	);
 
-	auto it = getCharacterBreakIterator(utext.get());
+	auto &[offsets, byte_offsets, sizes, bases, starts, deltas] = blocks;
+	offsets.reserve(runs + 1);
+	byte_offsets.reserve(runs + 1);
+	sizes.reserve(runs);
 
-	size_t offset = 0;
-	size_t previous_character_size = 0;
-	for (
-		auto start = it->first(), end = it->next();
-		end != icu::BreakIterator::DONE;
-		start = end, end = it->next(), ++offset
-	)
+	auto characters_of = [&](size_t run)
 	{
-		size_t character_size = end - start;
+		return run_offsets[run + 1] - run_offsets[run];
+	};
+	auto is_short = [&](size_t run)
+	{
+		return 
+			run_sizes[run] == 0 || 
+			characters_of(run) < min_block_characters;
+	};
 
-		if (character_size != previous_character_size)
+	// Store characters of runs [first, last) in chunks
+	auto add_chunks = [&](size_t first, size_t last)
+	{
+		size_t base = 0;
+		size_t count = 0;
+		for (auto run = first; run != last; ++run)
 		{
-			layout.offsets.push_back(offset);
-			layout.blocks.push_back(
-				block{
-					.character_size = character_size,
-					.byte_offset = size_t(start)
+			for (size_t i = 0; i < characters_of(run); ++i)
+			{
+				auto start = run_byte_offsets[run] + i * run_sizes[run];
+				if (
+					(run == first && i == 0) ||
+					count == chunk_capacity || 
+					start - base > UINT8_MAX
+				)
+				{
+					offsets.push_back(run_offsets[run] + i);
+					byte_offsets.push_back(bases.size());
+					sizes.push_back(0);
+					bases.push_back(start);
+					starts.push_back(deltas.size());
+					base = start;
+					count = 0;
 				}
-			);
-			previous_character_size = character_size;
+				deltas.push_back(uint8_t(start - base));
+				++count;
+			}
 		}
+	};
+	auto add_run = [&](size_t run)
+	{
+		if (run_sizes[run] == 0) { return add_chunks(run, run + 1); }
+
+		offsets.push_back(run_offsets[run]);
+		byte_offsets.push_back(run_byte_offsets[run]);
+		sizes.push_back(run_sizes[run]);
+	};
+
+	for (size_t run = 0; run < runs;)
+	{
+		auto fragment_end = run;
+		while (fragment_end < runs && is_short(fragment_end)) { ++fragment_end; }
+
+		if (fragment_end - run >= min_fragmented_blocks)
+		{
+			add_chunks(run, fragment_end);
+			run = fragment_end;
+			continue;
+		}
+
+		// Few short runs or a long one
+		do { add_run(run++); } while (run < fragment_end);
 	}
+	offsets.push_back(run_offsets.back());
+	byte_offsets.push_back(run_byte_offsets.back());
+}
+
+/// Collects blocks into plain columns, that are packed at the end
+struct appender
+{
+	/// Character offsets of blocks
+	std::vector<size_t> offsets;
+	/// Byte offsets of blocks
+	std::vector<size_t> byte_offsets;
+	/// Sizes of characters in blocks
+	std::vector<uint8_t> character_sizes;
+	/// Number of characters
+	size_t characters = 0;
+	/// Number of bytes
+	size_t bytes = 0;
 
+	/// Append characters of same size
+	void push(size_t character_size, size_t count = 1)
+	{
+		if (count == 0) { return; }
+
+		auto big = character_size > layout_blocks::max_character_size;
+		if (
+			big ||
+			character_sizes.empty() || 
+			character_sizes.back() != character_size
+		)
+		{
+			assert((!big || count == 1) && "big characters are separate");
+			offsets.push_back(characters);
+			byte_offsets.push_back(bytes);
+			character_sizes.push_back(big ? 0 : uint8_t(character_size));
+		}
+		characters += count;
+		bytes += count * character_size;
+	}
+
+	/// Append blocks of other appender, merging blocks of same size
+	void append(const appender &other)
+	{
+		for (size_t block = 0; block < other.offsets.size(); ++block)
+		{
+			auto last = block + 1 == other.offsets.size();
+			auto count = 
+				(last ? other.characters : other.offsets[block + 1]) - 
+				other.offsets[block];
+			auto size = 
+				(last ? other.bytes : other.byte_offsets[block + 1]) - 
+				other.byte_offsets[block];
+			push(size / count, count);
+		}
+	}
+
+	/// Remove all blocks, keeping memory
+	void clear() noexcept
+	{
+		offsets.clear();
+		byte_offsets.clear();
+		character_sizes.clear();
+		characters = 0;
+		bytes = 0;
+	}
+
+	/// Add number of characters and bytes after blocks
+	void close()
+	{
+		offsets.push_back(characters);
+		byte_offsets.push_back(bytes);
+	}
+
+	/// Free memory, if it's too big to keep for reuse
+	void trim() noexcept
+	{
+		if (offsets.capacity() > max_scratch_runs) { *this = {}; }
+	}
+
+	/// Get layout of appended blocks, allocated from resource
+	layout_blocks finish(std::pmr::memory_resource *resource)
+	{
+		close();
+		return layout_blocks(offsets, byte_offsets, character_sizes, resource);
+	}
+};
+
+} // namespace
+
+/// Layout from runs of characters
+layout_blocks::layout_blocks(
+	std::span<const size_t> run_offsets,
+	std::span<const size_t> run_byte_offsets,
+	std::span<const uint8_t> run_sizes,
+	std::pmr::memory_resource *resource
+)
+	: offsets(resource), 
+	  byte_offsets(resource), 
+	  character_sizes(resource),
+	  chunk_bases(resource),
+	  chunk_starts(resource),
+	  chunk_deltas(resource)
+{
+	// Only packed columns are allocated from resource
+	thread_local columns blocks;
+	blocks.clear();
+	compact(run_offsets, run_byte_offsets, run_sizes, blocks);
+
+	offsets = utility::packed_vector(blocks.offsets, resource);
+	byte_offsets = utility::packed_vector(blocks.byte_offsets, resource);
+	character_sizes.assign(blocks.sizes.begin(), blocks.sizes.end());
+	// Most strings have no chunks, their columns are already empty
+	if (!blocks.bases.empty())
+	{
+		chunk_bases = utility::packed_vector(blocks.bases, resource);
+		chunk_starts = utility::packed_vector(blocks.starts, resource);
+		chunk_deltas.assign(blocks.deltas.begin(), blocks.deltas.end());
+	}
+	blocks.trim();
+}
+
+/// Get run of a single character inside of chunk
+run layout_blocks::chunk_run(
+	size_t block_index, 
+	size_t character_index
+) const noexcept
+{
+	auto chunk = byte_offsets[block_index];
+	auto base = chunk_bases[chunk];
+	auto deltas = chunk_deltas.data() + chunk_starts[chunk];
+	auto index = character_index - offset(block_index);
+	auto start = base + deltas[index];
+	auto end = 
+		character_index + 1 < offset(block_index + 1) ? 
+			base + deltas[index + 1] : 
+			byte_offset(block_index + 1);
+	return {
+		block_index, character_index, character_index + 1, start, end - start
+	};
+}
+
+/// Get run of a single character, that contains byte
+run layout_blocks::character_at_byte(size_t byte_offset) const noexcept
+{
+	assert(byte_offset < bytes() && "out of range");
+
+	// The last block, that starts not after byte
+	size_t low = 0, high = block_count();
+	while (high - low > 1)
+	{
+		auto middle = low + (high - low) / 2;
+		if (this->byte_offset(middle) <= byte_offset) { low = middle; }
+		else { high = middle; }
+	}
+
+	if (!is_chunk(low))
+	{
+		auto run = this->run(low, offset(low));
+		auto index = 
+			run.first + (byte_offset - run.byte_offset) / run.character_size;
+		return {
+			low, index, index + 1, run.byte_offset_of(index), run.character_size
+		};
+	}
 
+	auto index = offset(low);
+	auto run = chunk_run(low, index);
+	while (run.byte_end() <= byte_offset) { run = chunk_run(low, ++index); }
+	return run;
+}
+
+/// Update layout after bytes in changed range of string 
+/// were replaced with new_length bytes
+size_t layout_blocks::update(
+	std::string_view bytes, 
+	byte_range changed, 
+	size_t new_length
+)
+{
+	assert(
+		changed.offset + changed.size <= this->bytes() &&
+		bytes.size() == this->bytes() - changed.size + new_length &&
+		"change doesn't match string"
+	);
+	if (block_count() == 0 || bytes.empty()) 
+	{ 
+		*this = of(bytes, resource()); 
+		return characters(); 
+	}
+
+	// Boundary before the character, that contains the byte before change,
+	// doesn't depend on changed bytes. 
+	// One more character is taken, in case change splits a code point
+	unicode::run start;
+	if (changed.offset != 0)
+	{
+		start = character_at_byte(changed.offset - 1);
+		if (start.first != 0) { start = character_at_byte(start.byte_offset - 1); }
+	}
+
+	// Characters of changed blocks, starting with ones before the boundary.
+	// Buffers are reused, so that small changes don't allocate
+	thread_local appender appender;
+	appender.clear();
+	appender.characters = offset(start.block);
+	appender.bytes = byte_offset(start.block);
+	auto push_block = [&](size_t block, size_t first, size_t last)
+	{
+		if (!is_chunk(block)) 
+		{ 
+			return appender.push(character_sizes[block], last - first); 
+		}
+		for (auto i = first; i < last; ++i) 
+		{ 
+			appender.push(chunk_run(block, i).character_size); 
+		}
+	};
+	push_block(start.block, offset(start.block), start.first);
+
+	// Re-segment until boundary after change, that was a boundary before it.
+	// Text after such boundary is segmented the same way
+	auto change_end = changed.offset + new_length;
+	auto shift = new_length - changed.size;
+	auto synchronized = start.byte_offset == bytes.size();
+	unicode::run end{block_count(), characters()};
+	auto is_synchronized = [&](size_t position)
+	{
+		auto old_position = position - shift;
+		if (old_position == this->bytes()) 
+		{ 
+			end = {block_count(), characters()};
+			return true; 
+		}
+
+		end = character_at_byte(old_position);
+		return end.byte_offset == old_position;
+	};
+	auto push = [&](size_t character_size, size_t count)
+	{
+		if (count == 0) { return true; }
+
+		auto position = appender.bytes;
+		size_t synchronized_count = 1;
+		if (change_end > position)
+		{
+			synchronized_count = 
+				(change_end - position + character_size - 1) / character_size;
+		}
+		for (; synchronized_count <= count; ++synchronized_count)
+		{
+			if (is_synchronized(position + synchronized_count * character_size))
+			{
+				synchronized = true;
+				appender.push(character_size, synchronized_count);
+				return false;
+			}
+		}
+		appender.push(character_size, count);
+		return true;
+	};
+	for (size_t step = 4096; !synchronized; step *= 2)
+	{
+		grapheme::for_each_run_in_prefix(
+			bytes.substr(appender.bytes), step, push
+		);
+	}
+
+	// Characters after boundary in its block
+	auto end_block = end.block;
+	if (end_block != block_count() && end.first != offset(end_block))
+	{
+		push_block(end_block, end.first, offset(end_block + 1));
+		++end_block;
+	}
+	appender.close();
+	thread_local columns blocks;
+	blocks.clear();
+	compact(appender.offsets, appender.byte_offsets, appender.character_sizes, blocks);
+	assert(
+		blocks.byte_offsets.back() == byte_offset(end_block) + shift && 
+		"segmentation is not synchronized"
+	);
+
+	// Replace changed blocks and shift the following ones
+	auto chunk_index = [&](size_t block)
+	{
+		return chunk_bases.visit(
+			[&](auto bases)
+			{
+				return size_t(
+					std::lower_bound(
+						bases.begin(), bases.end(), byte_offset(block)
+					) - 
+					bases.begin()
+				);
+			}
+		);
+	};
+	auto delta_index = [&](size_t chunk)
+	{
+		return chunk < chunk_starts.size() ? 
+			chunk_starts[chunk] : 
+			chunk_deltas.size();
+	};
+	auto first_chunk = chunk_index(start.block);
+	auto last_chunk = chunk_index(end_block);
+	auto first_delta = delta_index(first_chunk);
+	auto last_delta = delta_index(last_chunk);
+
+	auto new_blocks = blocks.sizes.size();
+	auto new_chunks = blocks.bases.size();
+	auto character_shift = blocks.offsets.back() - offset(end_block);
+	auto chunk_shift = new_chunks - (last_chunk - first_chunk);
+	auto delta_shift = blocks.deltas.size() - (last_delta - first_delta);
+	auto shifted = [](size_t delta)
+	{
+		return [delta](size_t, size_t value) { return value + delta; };
+	};
+
+	character_sizes.erase(
+		character_sizes.begin() + start.block, 
+		character_sizes.begin() + end_block
+	);
+	character_sizes.insert(
+		character_sizes.begin() + start.block, 
+		blocks.sizes.begin(), 
+		blocks.sizes.end()
+	);
+
+	offsets.replace(
+		start.block, end_block, std::span(blocks.offsets).first(new_blocks)
+	);
+	offsets.transform(start.block + new_blocks, shifted(character_shift));
+
+	for (size_t i = 0; i < new_blocks; ++i)
+	{
+		if (blocks.sizes[i] == 0) { blocks.byte_offsets[i] += first_chunk; }
+	}
+	byte_offsets.replace(
+		start.block, end_block, std::span(blocks.byte_offsets).first(new_blocks)
+	);
+	byte_offsets.transform(
+		start.block + new_blocks, 
+		[&](size_t block, size_t value)
+		{
+			return value + (
+				block < block_count() && is_chunk(block) ? chunk_shift : shift
+			);
+		}
+	);
+
+	chunk_bases.replace(first_chunk, last_chunk, blocks.bases);
+	chunk_bases.transform(first_chunk + new_chunks, shifted(shift));
+
+	for (auto &start : blocks.starts) { start += first_delta; }
+	chunk_starts.replace(first_chunk, last_chunk, blocks.starts);
+	chunk_starts.transform(first_chunk + new_chunks, shifted(delta_shift));
+
+	chunk_deltas.erase(
+		chunk_deltas.begin() + first_delta, 
+		chunk_deltas.begin() + last_delta
+	);
+	chunk_deltas.insert(
+		chunk_deltas.begin() + first_delta, 
+		blocks.deltas.begin(), 
+		blocks.deltas.end()
+	);
+	return blocks.offsets.back();
+}
+
+/// Split string into blocks
+layout_blocks layout_blocks::of(
+	std::string_view bytes, 
+	std::pmr::memory_resource *resource
+)
+{
+	if (bytes.empty()) { return layout_blocks(resource); }
+
+	// Runs are collected in buffers, reused by calls on the same thread
+	thread_local appender appender;
+	appender.clear();
+	grapheme::for_each_run(
+		bytes, 
+		[&](size_t character_size, size_t count)
+		{
+			appender.push(character_size, count);
+			return true;
+		}
+	);
+	auto layout = appender.finish(resource);
+	appender.trim();
 	return layout;
-}
\ No newline at end of file
+}
+
+/// Split string into blocks on specified number of threads
+layout_blocks layout_blocks::parallel_of(
+	std::string_view bytes, 
+	size_t threads,
+	std::pmr::memory_resource *resource
+)
+{
+	/// Minimal number of bytes for a single task
+	constexpr size_t min_part_size = 1 << 20;
+	/// Number of tasks per thread. Extra tasks let threads balance load
+	constexpr size_t tasks_per_thread = 4;
+
+	auto &pool = utility::thread_pool::shared(threads);
+	auto part_size = std::max(
+		min_part_size,
+		(bytes.size() + pool.size() * tasks_per_thread - 1) / 
+			(pool.size() * tasks_per_thread)
+	);
+	if (bytes.size() <= part_size) { return of(bytes, resource); }
+
+	// Parts start at boundaries, that don't depend on text before them.
+	// Part without such boundary is joined with the next one
+	std::vector<size_t> starts = {0};
+	for (auto start = part_size; start < bytes.size(); start += part_size)
+	{
+		auto last = std::min(start + part_size, bytes.size());
+		auto boundary = grapheme::find_safe_boundary(bytes, start, last);
+		if (boundary != last) { starts.push_back(boundary); }
+	}
+	starts.push_back(bytes.size());
+
+	// Segment parts
+	auto parts = starts.size() - 1;
+	std::vector<appender> appenders(parts);
+	{
+		std::vector<utility::thread_pool::task> tasks;
+		for (size_t part = 0; part < parts; ++part)
+		{
+			tasks.push_back(
+				[&, part]
+				{
+					grapheme::for_each_run(
+						bytes.substr(starts[part], starts[part + 1] - starts[part]),
+						[&](size_t character_size, size_t count)
+						{
+							appenders[part].push(character_size, count);
+							return true;
+						}
+					);
+				}
+			);
+		}
+		pool.run(std::move(tasks));
+	}
+
+	// Stitch runs of parts, merging runs of same size at their seams
+	appender result;
+	for (auto &part : appenders) { result.append(part); }
+	return result.finish(resource);
+}
@@ -0,0 +1,119 @@
+#include "unicode/layout_builder.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "thread_pool.hpp"
+
+using namespace unicode;
+
+namespace
+{
+
+/// Size of the first block of arena. Next blocks grow geometrically
+constexpr size_t initial_arena_size = 1 << 16;
+/// Minimal number of strings for a single task
+constexpr size_t min_part_size = 1 << 12;
+/// Number of tasks per thread. Extra tasks let threads balance load
+constexpr size_t tasks_per_thread = 4;
+
+} // namespace
+
+/// Builder, that segments batches on specified number of threads
+layout_builder::layout_builder(
+	size_t threads,
+	std::pmr::memory_resource *upstream
+)
+	: upstream(upstream)
+{
+	if (threads > 1) { pool = std::make_unique<utility::thread_pool>(threads); }
+}
+
+/// Stop worker threads
+layout_builder::~layout_builder() = default;
+
+/// Get number of threads, used by builder
+size_t layout_builder::threads() const noexcept
+{
+	return pool ? pool->size() : 1;
+}
+
+/// Get arena of part of batch
+std::pmr::memory_resource *layout_builder::arena(size_t part)
+{
+	while (arenas.size() <= part)
+	{
+		arenas.push_back(
+			std::make_unique<std::pmr::monotonic_buffer_resource>(
+				initial_arena_size, upstream
+			)
+		);
+	}
+	return arenas[part].get();
+}
+
+/// Build layouts of strings in the same order
+std::vector<layout> layout_builder::build(
+	std::span<const std::string_view> strings
+)
+{
+	// Layouts are move-constructed, as assignment would copy them 
+	// into default resource of the target
+	auto build_part = [](
+		std::span<const std::string_view> strings, 
+		std::pmr::memory_resource *arena,
+		std::vector<layout> &layouts
+	)
+	{
+		// Runs are collected in buffers of the thread, reused by all strings.
+		// Blocks are indexed in place
+		layouts.reserve(layouts.size() + strings.size());
+		for (auto string : strings) 
+		{ 
+			layouts.emplace_back(layout_blocks::of(string, arena)); 
+		}
+	};
+
+	std::vector<layout> layouts;
+	auto parts = std::min(
+		threads() * tasks_per_thread,
+		(strings.size() + min_part_size - 1) / min_part_size
+	);
+	if (!pool || parts <= 1)
+	{
+		build_part(strings, arena(0), layouts);
+		return layouts;
+	}
+
+	// Arenas are created in advance, tasks only use them
+	auto part_size = (strings.size() + parts - 1) / parts;
+	std::vector<std::vector<layout>> part_layouts(parts);
+	std::vector<utility::thread_pool::task> tasks;
+	for (size_t part = 0; part < parts; ++part)
+	{
+		auto first = std::min(part * part_size, strings.size());
+		auto count = std::min(part_size, strings.size() - first);
+		tasks.push_back(
+			[&, part, arena = arena(part), first, count]
+			{
+				build_part(
+					strings.subspan(first, count), arena, part_layouts[part]
+				);
+			}
+		);
+	}
+	pool->run(std::move(tasks));
+
+	layouts.reserve(strings.size());
+	for (auto &part : part_layouts)
+	{
+		std::move(part.begin(), part.end(), std::back_inserter(layouts));
+	}
+	return layouts;
+}
+
+/// Free memory of all built layouts at once
+void layout_builder::reset() noexcept
+{
+	for (auto &arena : arenas) { arena->release(); }
+}
@@ -0,0 +1,353 @@
+/// Serialized layout format.
+/// All integers are little-endian, sections are aligned to 8 bytes:
+/// - magic "ULAY" and uint32 version;
+/// - uint64 size of string and uint64 checksum of string;
+/// - packed columns offsets, byte_offsets, chunk_bases, chunk_starts,
+///   each as uint64 width of elements, uint64 count and elements;
+/// - byte columns character_sizes and chunk_deltas, 
+///   each as uint64 count and bytes;
+/// - uint64 checksum of all previous bytes.
+/// Columns are stored as in memory, 
+/// so on little-endian platforms they are loaded with memcpy
+
+#include "unicode/layout.hpp"
+
+#include <bit>
+#include <cstring>
+
+using namespace unicode;
+
+namespace
+{
+
+/// Magic bytes at the start of serialized layout
+constexpr char magic[4] = {'U', 'L', 'A', 'Y'};
+
+/// Reverse order of bytes of integer
+template<typename T>
+T byteswap(T value) noexcept
+{
+	T result = 0;
+	for (size_t i = 0; i < sizeof(T); ++i)
+	{
+		result = T((result << 8) | (value & 0xFF));
+		value = T(value >> 8);
+	}
+	return result;
+}
+
+/// Load little-endian integer
+template<typename T>
+T load(const std::byte *data) noexcept
+{
+	T value;
+	std::memcpy(&value, data, sizeof(T));
+	if constexpr (std::endian::native == std::endian::big) 
+	{ 
+		value = byteswap(value); 
+	}
+	return value;
+}
+
+/// Get 64-bit checksum of bytes, that is same on any platform
+uint64_t checksum(std::span<const std::byte> bytes) noexcept
+{
+	constexpr uint64_t multiplier = 0x9E3779B97F4A7C15;
+
+	uint64_t hash = bytes.size() * multiplier;
+	auto mix = [&](uint64_t word)
+	{
+		hash = std::rotl((hash ^ word) * multiplier, 29);
+	};
+
+	size_t i = 0;
+	for (; i + 8 <= bytes.size(); i += 8) { mix(load<uint64_t>(&bytes[i])); }
+
+	uint64_t tail = 0;
+	for (size_t shift = 0; i < bytes.size(); ++i, shift += 8)
+	{
+		tail |= uint64_t(bytes[i]) << shift;
+	}
+	mix(tail);
+	return hash ^ (hash >> 32);
+}
+
+/// Writer of serialized layout
+class writer
+{
+public:
+	/// Serialized bytes
+	std::vector<std::byte> data;
+
+	/// Append little-endian integer
+	template<typename T>
+	void write(T value)
+	{
+		for (size_t i = 0; i < sizeof(T); ++i)
+		{
+			data.push_back(std::byte(value >> (8 * i)));
+		}
+	}
+
+	/// Append number of elements and elements
+	template<typename T>
+	void write(std::span<const T> values)
+	{
+		write<uint64_t>(values.size());
+		if constexpr (std::endian::native == std::endian::little)
+		{
+			auto bytes = std::as_bytes(values);
+			data.insert(data.end(), bytes.begin(), bytes.end());
+		}
+		else
+		{
+			for (auto value : values) { write(value); }
+		}
+		align();
+	}
+
+	/// Append width of elements, their number and elements
+	void write(const utility::packed_vector &values)
+	{
+		write<uint64_t>(values.width());
+		values.visit([&](auto values) { write(values); });
+	}
+
+	/// Pad data to 8 bytes
+	void align() { data.resize((data.size() + 7) / 8 * 8); }
+};
+
+/// Reader of serialized layout. Fails on reads out of data
+class reader
+{
+public:
+	/// Read serialized bytes into vectors, allocated from resource
+	reader(
+		std::span<const std::byte> data, 
+		std::pmr::memory_resource *resource
+	) noexcept 
+		: data(data), resource(resource) 
+	{}
+
+	/// Has any read failed?
+	bool failed = false;
+
+	/// Get number of read bytes
+	size_t position() const noexcept { return offset; }
+
+	/// Read little-endian integer
+	template<typename T>
+	T read() noexcept
+	{
+		if (data.size() - offset < sizeof(T))
+		{
+			failed = true;
+			return 0;
+		}
+		auto value = load<T>(&data[offset]);
+		offset += sizeof(T);
+		return value;
+	}
+
+	/// Read number of elements and elements into vector, e.g. small_vector
+	template<typename Vector>
+	Vector read_vector()
+	{
+		using T = typename Vector::value_type;
+
+		Vector values(resource);
+		auto count = read<uint64_t>();
+		if (failed || count > (data.size() - offset) / sizeof(T))
+		{
+			failed = true;
+			return values;
+		}
+
+		values.resize(count);
+		std::memcpy(values.data(), &data[offset], count * sizeof(T));
+		if constexpr (std::endian::native == std::endian::big)
+		{
+			for (auto &value : values) { value = byteswap(value); }
+		}
+		offset += count * sizeof(T);
+		align();
+		return values;
+	}
+
+	/// Read width of elements, their number and elements
+	utility::packed_vector read_packed()
+	{
+		switch (read<uint64_t>())
+		{
+			case 2: return read_elements<uint16_t>();
+			case 4: return read_elements<uint32_t>();
+			case 8: return read_elements<uint64_t>();
+			default:
+				failed = true;
+				return utility::packed_vector(resource);
+		}
+	}
+
+private:
+	/// Read packed elements of specified width
+	template<typename T>
+	utility::packed_vector read_elements()
+	{
+		using elements = utility::packed_vector::elements<T>;
+		return utility::packed_vector::adopt(read_vector<elements>());
+	}
+
+	/// Serialized bytes
+	std::span<const std::byte> data;
+	/// Resource of read vectors
+	std::pmr::memory_resource *resource;
+	/// Number of read bytes
+	size_t offset = 0;
+
+	/// Skip padding to 8 bytes
+	void align() noexcept
+	{
+		offset = std::min(data.size(), (offset + 7) / 8 * 8);
+	}
+};
+
+} // namespace
+
+/// Serialize layout of string
+std::vector<std::byte> layout_blocks::serialize(std::string_view bytes) const
+{
+	assert(bytes.size() == this->bytes() && "layout of other string");
+
+	writer writer;
+	for (auto c : magic) { writer.write(c); }
+	writer.write(format_version);
+	writer.write<uint64_t>(bytes.size());
+	writer.write(checksum(std::as_bytes(std::span(bytes))));
+
+	writer.write(offsets);
+	writer.write(byte_offsets);
+	writer.write(chunk_bases);
+	writer.write(chunk_starts);
+	writer.write(std::span(character_sizes));
+	writer.write(std::span(chunk_deltas));
+
+	writer.write(checksum(writer.data));
+	return std::move(writer.data);
+}
+
+/// Deserialize layout of string
+std::optional<layout_blocks> layout_blocks::deserialize(
+	std::span<const std::byte> data,
+	std::string_view bytes,
+	std::pmr::memory_resource *resource
+)
+{
+	reader reader(data, resource);
+	for (auto c : magic) 
+	{ 
+		if (reader.read<char>() != c) { return std::nullopt; } 
+	}
+	if (
+		reader.read<uint32_t>() != format_version ||
+		reader.read<uint64_t>() != bytes.size()
+	)
+	{
+		return std::nullopt;
+	}
+	auto content_checksum = reader.read<uint64_t>();
+
+	layout_blocks layout(resource);
+	layout.offsets = reader.read_packed();
+	layout.byte_offsets = reader.read_packed();
+	layout.chunk_bases = reader.read_packed();
+	layout.chunk_starts = reader.read_packed();
+	layout.character_sizes = 
+		reader.read_vector<decltype(layout.character_sizes)>();
+	layout.chunk_deltas = reader.read_vector<decltype(layout.chunk_deltas)>();
+
+	auto end = reader.position();
+	if (
+		reader.failed ||
+		reader.read<uint64_t>() != checksum(data.first(end)) ||
+		reader.failed
+	)
+	{
+		return std::nullopt;
+	}
+
+	// Checksum doesn't prove, that columns were written by serialize()
+	if (
+		!layout.is_consistent(bytes.size()) ||
+		content_checksum != checksum(std::as_bytes(std::span(bytes)))
+	)
+	{
+		return std::nullopt;
+	}
+	return layout;
+}
+
+/// Do columns describe blocks, that cover string of specified size?
+bool layout_blocks::is_consistent(size_t bytes) const noexcept
+{
+	auto blocks = character_sizes.size();
+	if (
+		offsets.size() != blocks + 1 ||
+		byte_offsets.size() != blocks + 1 ||
+		chunk_starts.size() != chunk_bases.size() ||
+		offsets[0] != 0 ||
+		offsets[blocks] > bytes ||
+		byte_offsets[blocks] != bytes
+	)
+	{
+		return false;
+	}
+
+	// Blocks aren't empty and follow each other without gaps
+	size_t position = 0;
+	for (size_t block = 0; block < blocks; ++block)
+	{
+		auto first = offsets[block], last = offsets[block + 1];
+		if (last <= first) { return false; }
+		auto count = last - first;
+
+		if (auto size = character_sizes[block]; size != 0)
+		{
+			if (byte_offsets[block] != position) { return false; }
+			position += count * size;
+			continue;
+		}
+
+		// Deltas of chunk start at its base and grow inside of string
+		auto chunk = byte_offsets[block];
+		if (chunk >= chunk_bases.size() || chunk_bases[chunk] != position) 
+		{ 
+			return false; 
+		}
+		auto start = chunk_starts[chunk];
+		if (
+			start > chunk_deltas.size() || 
+			count > chunk_deltas.size() - start ||
+			chunk_deltas[start] != 0
+		)
+		{
+			return false;
+		}
+		for (size_t i = start + 1; i < start + count; ++i)
+		{
+			if (chunk_deltas[i] <= chunk_deltas[i - 1]) { return false; }
+		}
+		position += chunk_deltas[start + count - 1] + 1;
+		if (position > bytes) { return false; }
+
+		// The last character of chunk ends, where the next block starts
+		size_t next = byte_offsets[block + 1];
+		if (block + 1 != blocks && character_sizes[block + 1] == 0)
+		{
+			if (next >= chunk_bases.size()) { return false; }
+			next = chunk_bases[next];
+		}
+		if (next < position || next > bytes) { return false; }
+		position = next;
+	}
+	return position == bytes;
+}
@@ -0,0 +1,87 @@
+#include "unicode/lazy_layout.hpp"
+
+#include "runs.hpp"
+
+using namespace unicode;
+
+/// Segment at least one more character
+void lazy_layout::extend() const
+{
+	assert(!is_complete() && "layout is complete");
+
+	auto characters = offsets.back();
+	auto bytes = byte_offsets.back();
+	offsets.pop_back();
+	byte_offsets.pop_back();
+
+	// Runs are never merged with segmented ones, 
+	// so that runs, held by iterators, stay valid
+	auto first = true;
+	auto push = [&](size_t character_size, size_t count)
+	{
+		if (count == 0) { return true; }
+		if (first || character_sizes.back() != character_size)
+		{
+			first = false;
+			offsets.push_back(characters);
+			byte_offsets.push_back(bytes);
+			character_sizes.push_back(character_size);
+		}
+		characters += count;
+		bytes += count * character_size;
+		return true;
+	};
+	auto rest = text.substr(bytes);
+	while (grapheme::for_each_run_in_prefix(rest, step, push) == 0) 
+	{ 
+		step *= 2; 
+	}
+	step *= 2;
+
+	offsets.push_back(characters);
+	byte_offsets.push_back(bytes);
+}
+
+/// Update layout after bytes in changed range of string 
+/// were replaced with new_length bytes
+void lazy_layout::update(
+	std::string_view bytes, 
+	byte_range changed, 
+	[[maybe_unused]] size_t new_length
+)
+{
+	assert(
+		changed.offset + changed.size <= text.size() &&
+		bytes.size() == text.size() - changed.size + new_length &&
+		"change doesn't match string"
+	);
+	text = bytes;
+	step = first_step;
+
+	// Keep runs before the character, that contains the byte before change,
+	// and one more character, in case change splits a code point
+	size_t block = 0;
+	size_t characters = 0;
+	auto bytes_kept = std::min(changed.offset, byte_offsets.back());
+	for (int i = 0; i < 2 && bytes_kept != 0; ++i)
+	{
+		block = byte_offsets.visit([bytes_kept](auto values)
+		{
+			return size_t(
+				std::upper_bound(values.begin(), values.end(), bytes_kept - 1) - 
+				values.begin()
+			);
+		}) - 1;
+		auto index = 
+			(bytes_kept - 1 - byte_offsets[block]) / character_sizes[block];
+		characters = offsets[block] + index;
+		bytes_kept = byte_offsets[block] + index * character_sizes[block];
+	}
+	if (bytes_kept != byte_offsets[block]) { ++block; }
+
+	offsets.replace(block, offsets.size(), {});
+	byte_offsets.replace(block, byte_offsets.size(), {});
+	character_sizes.replace(block, character_sizes.size(), {});
+	offsets.push_back(characters);
+	byte_offsets.push_back(bytes_kept);
+}
@@ -0,0 +1,180 @@
+#include "unicode/mapped_string_view.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace unicode;
+
+namespace
+{
+
+/// Get error for last failed system call
+std::system_error last_error(const std::filesystem::path &path)
+{
+	return std::system_error(errno, std::generic_category(), path.string());
+}
+
+/// Map whole file read-only. Empty files are not mapped
+std::string_view map(const std::filesystem::path &path)
+{
+	auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (file == -1) { throw last_error(path); }
+
+	struct stat status;
+	if (::fstat(file, &status) == -1)
+	{
+		auto error = last_error(path);
+		::close(file);
+		throw error;
+	}
+
+	auto size = size_t(status.st_size);
+	void *data = nullptr;
+	if (size != 0)
+	{
+		data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data == MAP_FAILED)
+		{
+			auto error = last_error(path);
+			::close(file);
+			throw error;
+		}
+	}
+	::close(file);
+	return {static_cast<const char *>(data), size};
+}
+
+/// Unmap file, mapped by map()
+void unmap(std::string_view bytes) noexcept
+{
+	if (!bytes.empty())
+	{
+		::munmap(const_cast<char *>(bytes.data()), bytes.size());
+	}
+}
+
+/// Advise kernel how mapped bytes will be accessed
+void advise(std::string_view bytes, int advice) noexcept
+{
+	if (!bytes.empty())
+	{
+		::madvise(const_cast<char *>(bytes.data()), bytes.size(), advice);
+	}
+}
+
+/// Load layout of text from sidecar file into memory.
+/// Sidecar is unmapped after that, as layout columns own their storage.
+/// Returns nothing, if it's missing or stale
+std::optional<layout> load_layout(
+	const std::filesystem::path &sidecar,
+	std::string_view text
+)
+{
+	std::string_view data;
+	try { data = map(sidecar); }
+	catch (const std::system_error &) { return std::nullopt; }
+
+	// Checksums read both files in a single pass
+	advise(data, MADV_SEQUENTIAL);
+	auto layout = layout::deserialize(std::as_bytes(std::span(data)), text);
+	unmap(data);
+	return layout;
+}
+
+/// Write all bytes to file
+bool write_all(int file, std::span<const std::byte> data) noexcept
+{
+	while (!data.empty())
+	{
+		auto written = ::write(file, data.data(), data.size());
+		if (written == -1 && errno == EINTR) { continue; }
+		if (written <= 0) { return false; }
+		data = data.subspan(size_t(written));
+	}
+	return true;
+}
+
+/// Create file with unique name next to path, that others can read,
+/// unless umask forbids it. Returns its descriptor or -1.
+/// Unlike mkstemp, file isn't limited to owner
+int create_temporary(const std::filesystem::path &path, std::string &name)
+{
+	static std::atomic<unsigned> counter = 0;
+	for (auto attempts = 0; attempts < 100; ++attempts)
+	{
+		name = 
+			path.string() + "." + std::to_string(::getpid()) + "." +
+			std::to_string(counter++);
+		auto file = ::open(
+			name.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666
+		);
+		if (file != -1 || errno != EEXIST) { return file; }
+	}
+	return -1;
+}
+
+/// Save layout of text to sidecar file.
+/// File is replaced atomically, errors are ignored.
+/// Temporary file has a unique name, 
+/// so processes, that open the same file, don't write into each other's one
+void save_layout(
+	const std::filesystem::path &sidecar,
+	std::string_view text,
+	const layout &layout
+)
+{
+	auto data = layout.serialize(text);
+
+	std::string temporary;
+	auto file = create_temporary(sidecar, temporary);
+	if (file == -1) { return; }
+
+	auto saved = write_all(file, data);
+	saved = ::close(file) == 0 && saved;
+
+	std::error_code error;
+	if (saved) { std::filesystem::rename(temporary, sidecar, error); }
+	if (!saved || error) { std::filesystem::remove(temporary, error); }
+}
+
+} // namespace
+
+/// Map file and load its layout from sidecar into memory
+mapped_string_view::mapped_string_view(const std::filesystem::path &path)
+	: text(map(path))
+{
+	// Destructor doesn't run, if constructor throws
+	try
+	{
+		// Whole text is read sequentially by checksum or segmentation, 
+		// and randomly after that
+		advise(text, MADV_SEQUENTIAL);
+		auto sidecar = sidecar_path(path);
+		auto layout = load_layout(sidecar, text);
+		loaded = layout.has_value();
+		if (!layout)
+		{
+			layout = layout::of(text);
+			save_layout(sidecar, text, *layout);
+		}
+		advise(text, MADV_RANDOM);
+		characters = string_view(text, shared_layout(std::move(*layout)));
+	}
+	catch (...)
+	{
+		unmap(text);
+		throw;
+	}
+}
+
+/// Unmap file
+mapped_string_view::~mapped_string_view() { unmap(text); }
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+#include "ascii.hpp"
+#include "grapheme.hpp"
+
+namespace unicode::grapheme
+{
+
+/// Minimal length of ASCII run, that is added without segmentation.
+/// Shorter runs (e.g spaces between words) are segmented with neighbours
+constexpr size_t min_ascii_run = 16;
+
+/// Find end of text, that must be segmented with grapheme rules.
+/// It includes the first byte of the next long enough ASCII run
+inline const char *find_island_end(const char *first, const char *last) noexcept
+{
+	while (first != last)
+	{
+		while (first != last && (uint8_t(*first) >= 0x80 || *first == '\r'))
+		{
+			++first;
+		}
+		auto run_end = ascii::find_non_ascii_or_cr(first, last);
+		if (
+			first != run_end && 
+			(run_end == last || size_t(run_end - first) >= min_ascii_run)
+		)
+		{
+			return first + 1;
+		}
+		first = run_end;
+	}
+	return last;
+}
+
+/// Is there a boundary between bytes, no matter what text is before them?
+/// That's true after LF and controls (GB4), after CR, unless it's CR LF,
+/// and between ASCII characters (GB5, GB999)
+constexpr bool is_safe_boundary(char previous, char next) noexcept
+{
+	if (uint8_t(previous) >= 0x80) { return false; }
+	if (previous == '\r') { return next != '\n'; }
+	if (uint8_t(previous) < 0x20 || previous == 0x7F) { return true; }
+	return uint8_t(next) < 0x80;
+}
+
+/// Find the first safe boundary in range [first, last) of text.
+/// Returns last, if there is none
+inline size_t find_safe_boundary(
+	std::string_view bytes, 
+	size_t first, 
+	size_t last
+) noexcept
+{
+	for (first = std::max<size_t>(first, 1); first < last; ++first)
+	{
+		if (is_safe_boundary(bytes[first - 1], bytes[first])) { return first; }
+	}
+	return last;
+}
+
+/// Split text, starting at a cluster boundary, into runs of characters.
+/// Calls push(character_size, count) for each run in order.
+/// Consecutive runs may have same size, count may be 0.
+/// Stops early, if push returns false
+template<typename Push>
+void for_each_run(std::string_view bytes, Push &&push)
+{
+	auto data = bytes.data();
+	auto last = data + bytes.size();
+	auto current = data;
+	while (current != last)
+	{
+		// Each ASCII character is separate,
+		// unless it is followed by combining character
+		auto stop = ascii::find_non_ascii_or_cr(current, last);
+		if (stop == last)
+		{
+			push(1, last - current);
+			return;
+		}
+
+		// CR is separate, unless it's followed by LF.
+		// There are always breaks before and after CR LF
+		if (*stop == '\r')
+		{
+			auto size = (stop + 1 != last && stop[1] == '\n') ? 2 : 1;
+			if (!push(1, stop - current) || !push(size, 1)) { return; }
+			current = stop + size;
+			continue;
+		}
+
+		// Previous ASCII character may combine with non-ASCII text
+		auto island_start = stop == current ? current : stop - 1;
+		if (!push(1, island_start - current)) { return; }
+
+		auto island_end = find_island_end(stop, last);
+		auto island = std::string_view(island_start, island_end - island_start);
+
+		segmenter segmenter(island);
+		for (
+			size_t start = 0, end = segmenter.next(); 
+			end != segmenter.npos; 
+			start = end, end = segmenter.next()
+		)
+		{
+			if (!push(end - start, 1)) { return; }
+		}
+		current = island_end;
+	}
+}
+
+/// Split prefix of text, starting at a cluster boundary, into runs.
+/// Segments at most max_bytes, cut at a code point boundary.
+/// Unless the whole text is segmented, the last character isn't pushed,
+/// as it may continue after the cut. 
+/// Stops early, if push returns false.
+/// Returns number of bytes in pushed runs
+template<typename Push>
+size_t for_each_run_in_prefix(
+	std::string_view bytes, 
+	size_t max_bytes, 
+	Push &&push
+)
+{
+	size_t pushed = 0;
+	if (max_bytes >= bytes.size())
+	{
+		for_each_run(
+			bytes, 
+			[&](size_t character_size, size_t count)
+			{
+				pushed += character_size * count;
+				return push(character_size, count);
+			}
+		);
+		return pushed;
+	}
+
+	auto end = max_bytes;
+	while (end > 0 && (uint8_t(bytes[end]) & 0xC0) == 0x80) { --end; }
+
+	// Run is pushed, when the next one is known
+	size_t last_size = 0;
+	size_t last_count = 0;
+	bool stopped = false;
+	for_each_run(
+		bytes.substr(0, end), 
+		[&](size_t character_size, size_t count)
+		{
+			if (count == 0) { return true; }
+			if (last_count != 0)
+			{
+				pushed += last_size * last_count;
+				if (!push(last_size, last_count)) 
+				{ 
+					stopped = true;
+					return false; 
+				}
+			}
+			last_size = character_size;
+			last_count = count;
+			return true;
+		}
+	);
+	if (!stopped && last_count > 1)
+	{
+		pushed += last_size * (last_count - 1);
+		push(last_size, last_count - 1);
+	}
+	return pushed;
+}
+
+} // namespace unicode::grapheme
@@ -0,0 +1,89 @@
+#include "unicode/segment_view.hpp"
+
+#include "icu.hpp"
+
+using namespace unicode;
+
+namespace
+{
+
+/// Scratch buffers for more runs are freed after use, 
+/// smaller ones are kept, so that short strings don't allocate
+constexpr size_t max_scratch_runs = 1 << 16;
+
+/// Get factory of break iterators for segments
+BreakIteratorFactory factory_of(segment kind) noexcept
+{
+	switch (kind)
+	{
+		case segment::word: 
+			return icu::BreakIterator::createWordInstance;
+		case segment::sentence: 
+			return icu::BreakIterator::createSentenceInstance;
+		default: 
+			return icu::BreakIterator::createLineInstance;
+	}
+}
+
+} // namespace
+
+/// Split string into blocks of segments
+layout_blocks unicode::segments_of(std::string_view bytes, segment kind)
+{
+	if (bytes.empty()) { return {}; }
+
+	// Runs of segments of same size.
+	// Buffers are reused by calls on the same thread
+	thread_local std::vector<size_t> offsets;
+	thread_local std::vector<size_t> byte_offsets;
+	thread_local std::vector<uint8_t> sizes;
+	offsets.clear();
+	byte_offsets.clear();
+	sizes.clear();
+	size_t segments = 0;
+	auto push = [&](size_t start, size_t end)
+	{
+		auto size = end - start;
+		auto big = size > layout_blocks::max_character_size;
+		if (big || sizes.empty() || sizes.back() != size)
+		{
+			offsets.push_back(segments);
+			byte_offsets.push_back(start);
+			sizes.push_back(big ? 0 : uint8_t(size));
+		}
+		++segments;
+	};
+
+	// Text and iterator are reused too, so short strings don't allocate
+	thread_local LocalUText local;
+	auto utext = local.open(bytes);
+	icu::BreakIterator *it = nullptr;
+	if (utext) { it = getCachedBreakIterator(utext, factory_of(kind)); }
+	if (!it) 
+	{ 
+		// Without break iterator the whole string is a single segment
+		push(0, bytes.size()); 
+	}
+	else
+	{
+		for (
+			auto start = it->first(), end = it->next();
+			end != icu::BreakIterator::DONE;
+			start = end, end = it->next()
+		)
+		{
+			push(size_t(start), size_t(end));
+		}
+	}
+
+	offsets.push_back(segments);
+	byte_offsets.push_back(bytes.size());
+	layout_blocks layout(offsets, byte_offsets, sizes);
+	if (offsets.capacity() > max_scratch_runs)
+	{
+		offsets = {};
+		byte_offsets = {};
+		sizes = {};
+	}
+	return layout;
+}
@@ -0,0 +1,49 @@
+#include "unicode/sort_key.hpp"
+
+#include <numeric>
+
+#include "icu.hpp"
+
+using namespace unicode;
+
+/// Get sort key of UTF-8 string with default locale comparison rules
+sort_key sort_key::of(std::string_view str)
+{
+	std::vector<std::uint8_t> bytes;
+	appendSortKey(getDefaultCollator(), str, bytes);
+	return sort_key(std::move(bytes));
+}
+
+/// Compute keys of UTF-8 strings with default locale comparison rules
+sort_keys::sort_keys(std::span<const std::string_view> strings)
+{
+	auto collator = getDefaultCollator();
+
+	offsets.reserve(strings.size() + 1);
+	for (auto str : strings)
+	{
+		appendSortKey(collator, str, bytes);
+		offsets.push_back(bytes.size());
+	}
+}
+
+/// Get indexes of keys in ascending order
+std::vector<size_t> sort_keys::order(bool stable) const
+{
+	std::vector<size_t> indexes(size());
+	std::iota(indexes.begin(), indexes.end(), 0);
+
+	auto less = [this](size_t lhs, size_t rhs)
+	{
+		return sort_key::compare((*this)[lhs], (*this)[rhs]) < 0;
+	};
+	if (stable)
+	{
+		std::stable_sort(indexes.begin(), indexes.end(), less);
+	}
+	else
+	{
+		std::sort(indexes.begin(), indexes.end(), less);
+	}
+	return indexes;
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace unicode::utility
+{
+
+/// Pool of worker threads with a task queue per worker.
+/// Idle workers steal tasks from the queues of busy ones.
+/// Several threads may run tasks on the same pool at once
+class thread_pool
+{
+public:
+	/// Task to be executed by pool
+	using task = std::function<void()>;
+
+	/// Create pool that executes tasks on specified number of threads,
+	/// including the thread that calls run()
+	explicit thread_pool(size_t threads) 
+		: queues(std::max<size_t>(threads, 1))
+	{
+		for (size_t i = 1; i < queues.size(); ++i)
+		{
+			workers.emplace_back([this, i] { work(i); });
+		}
+	}
+
+	/// Stop and join workers
+	~thread_pool()
+	{
+		stopping = true;
+		++generation;
+		generation.notify_all();
+	}
+
+	/// Get pool with specified number of threads, shared by all callers,
+	/// so that threads aren't started and joined by each call.
+	/// Pools are created on first use and live until exit
+	static thread_pool &shared(size_t threads)
+	{
+		static std::mutex mutex;
+		static std::map<size_t, std::unique_ptr<thread_pool>> pools;
+
+		threads = std::max<size_t>(threads, 1);
+		std::lock_guard lock(mutex);
+		auto &pool = pools[threads];
+		if (!pool) { pool = std::make_unique<thread_pool>(threads); }
+		return *pool;
+	}
+
+	/// Get number of threads used by pool
+	size_t size() const noexcept { return queues.size(); }
+
+	/// Execute tasks and wait for all of them to finish.
+	/// Calling thread executes tasks too.
+	/// If tasks throw, the first exception is rethrown,
+	/// after all other tasks are finished
+	void run(std::vector<task> tasks)
+	{
+		if (tasks.empty()) { return; }
+
+		batch batch;
+		try
+		{
+			for (size_t i = 0; i < tasks.size(); ++i)
+			{
+				auto &queue = queues[i % queues.size()];
+				std::lock_guard lock(queue.mutex);
+				queue.tasks.push_back({std::move(tasks[i]), &batch});
+				++batch.remaining;
+			}
+		}
+		catch (...)
+		{
+			// Tasks, that are queued already, still reference batch
+			batch.fail(std::current_exception());
+		}
+		++generation;
+		generation.notify_all();
+
+		for (
+			auto seen = finished.load(); 
+			batch.remaining != 0; 
+			seen = finished.load()
+		)
+		{
+			if (!execute(0)) { finished.wait(seen); }
+		}
+		if (batch.error) { std::rethrow_exception(batch.error); }
+	}
+
+private:
+	/// Tasks of a single call of run()
+	struct batch
+	{
+		/// Number of tasks, that are not finished yet
+		std::atomic<size_t> remaining = 0;
+		/// Guards error
+		std::mutex mutex;
+		/// The first exception, thrown by tasks
+		std::exception_ptr error;
+
+		/// Remember the first exception
+		void fail(std::exception_ptr exception)
+		{
+			std::lock_guard lock(mutex);
+			if (!error) { error = std::move(exception); }
+		}
+	};
+
+	/// Task in queue with its batch
+	struct entry
+	{
+		task function;
+		batch *owner = nullptr;
+	};
+
+	/// Queue of tasks of a single worker
+	struct queue
+	{
+		std::mutex mutex;
+		std::deque<entry> tasks;
+	};
+
+	/// Queues of tasks. First one belongs to threads, that call run()
+	std::vector<queue> queues;
+	/// Incremented to wake up workers on new tasks or stop
+	std::atomic<size_t> generation = 0;
+	/// Incremented to wake up threads in run(), when a batch is finished
+	std::atomic<size_t> finished = 0;
+	/// Should workers stop?
+	std::atomic<bool> stopping = false;
+	/// Worker threads. Declared last to be joined before other members die
+	std::vector<std::jthread> workers;
+
+	/// Pop task from own queue or steal one from others
+	bool pop(size_t index, entry &task)
+	{
+		{
+			auto &own = queues[index];
+			std::lock_guard lock(own.mutex);
+			if (!own.tasks.empty())
+			{
+				task = std::move(own.tasks.back());
+				own.tasks.pop_back();
+				return true;
+			}
+		}
+		for (size_t i = 1; i < queues.size(); ++i)
+		{
+			auto &victim = queues[(index + i) % queues.size()];
+			std::lock_guard lock(victim.mutex);
+			if (!victim.tasks.empty())
+			{
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// Execute one task on behalf of worker. Returns false if there are none.
+	/// Exception of task is passed to its batch
+	bool execute(size_t index)
+	{
+		entry task;
+		if (!pop(index, task)) { return false; }
+
+		std::exception_ptr exception;
+		try { task.function(); }
+		catch (...) { exception = std::current_exception(); }
+		if (exception) { task.owner->fail(std::move(exception)); }
+		// Batch may die as soon as it's finished, so notify through pool
+		if (--task.owner->remaining == 0)
+		{
+			++finished;
+			finished.notify_all();
+		}
+		return true;
+	}
+
+	/// Main loop of worker thread
+	void work(size_t index)
+	{
+		while (!stopping)
+		{
+			auto seen = generation.load();
+			if (execute(index)) { continue; }
+			generation.wait(seen);
+		}
+	}
+};
+
+} // namespace unicode::utility
@@ -0,0 +1,31 @@
+#include "unicode/translation_layout.hpp"
+
+#include "ascii.hpp"
+#include "grapheme.hpp"
+
+using namespace unicode;
+
+/// Count code units in UTF-8 text
+code_unit_counts unicode::count_code_units(std::string_view bytes) noexcept
+{
+	code_unit_counts counts;
+
+	auto current = bytes.data();
+	auto last = current + bytes.size();
+	while (current != last)
+	{
+		// Each ASCII byte, including CR, is a code unit of all encodings
+		auto ascii_end = ascii::find_non_ascii_or_cr(current, last);
+		if (ascii_end != last && *ascii_end == '\r') { ++ascii_end; }
+		counts.code_points += ascii_end - current;
+		counts.utf16 += ascii_end - current;
+		current = ascii_end;
+		if (current == last || uint8_t(*current) < 0x80) { continue; }
+
+		auto decoded = grapheme::decode(current, last);
+		++counts.code_points;
+		counts.utf16 += decoded.code_point > 0xFFFF ? 2 : 1;
+		current += decoded.size;
+	}
+	return counts;
+}
@@ -0,0 +1,84 @@
+#include "unicode/utf8/comparator.hpp"
+
+#include <cassert>
+
+#include "../icu.hpp"
+
+using namespace unicode::utf8;
+
+/// Convert strength to ICU collator strength
+static icu::Collator::ECollationStrength toICU(strength strength) noexcept
+{
+	switch (strength)
+	{
+	case strength::primary: return icu::Collator::PRIMARY;
+	case strength::secondary: return icu::Collator::SECONDARY;
+	case strength::tertiary: return icu::Collator::TERTIARY;
+	case strength::quaternary: return icu::Collator::QUATERNARY;
+	case strength::identical: return icu::Collator::IDENTICAL;
+	}
+	return icu::Collator::TERTIARY;
+}
+
+/// Implementation with ICU collator
+struct comparator::implementation
+{
+	/// Collator, may be null if creation failed
+	std::unique_ptr<icu::Collator> collator;
+
+	/// Create collator for locale with strength
+	implementation(const icu::Locale &locale, utf8::strength strength)
+		: collator(createCollator(locale))
+	{
+		assert(collator && "coudn't create collator");
+		if (collator) { collator->setStrength(toICU(strength)); }
+	}
+};
+
+/// Comparator with default locale and tertiary strength
+comparator::comparator()
+	: impl(
+		std::make_shared<const implementation>(
+			icu::Locale::getDefault(), strength::tertiary
+		)
+	)
+{}
+
+/// Comparator with specified locale and strength
+comparator::comparator(const char *locale, utf8::strength strength)
+	: impl(
+		std::make_shared<const implementation>(icu::Locale(locale), strength)
+	)
+{}
+
+/// Compare two UTF-8 strings
+std::strong_ordering comparator::compare(
+	std::string_view lhs, 
+	std::string_view rhs
+) const noexcept
+{
+	if (!impl->collator)
+	{
+		/// Fallback to byte comparison
+		return lhs.compare(rhs) <=> 0; 
+	}
+
+	UErrorCode errorCode = U_ZERO_ERROR;
+	auto res = impl->collator->compareUTF8(lhs, rhs, errorCode);
+	if (U_FAILURE(errorCode))
+	{
+		assert(false && "collator error");
+		/// Fallback to byte comparison
+		return lhs.compare(rhs) <=> 0; 
+	}
+
+	return res <=> 0;
+}
+
+/// Get sort key of string, that is ordered as this comparator orders
+unicode::sort_key comparator::key(std::string_view str) const
+{
+	std::vector<std::uint8_t> bytes;
+	appendSortKey(impl->collator.get(), str, bytes);
+	return sort_key(std::move(bytes));
+}
@@ -0,0 +1,101 @@
+#include "unicode/utf8/compare.hpp"
+#include "unicode/string_view.hpp"
+#include "unicode/algorithm.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../sources/thread_pool.hpp"
+
+using namespace unicode;
+
+TEST(algorithm, sort)
+{
+	std::vector<std::string> strings = {
+		"в", "a\u0301", "б", "2", "A", "\u00e1", "a", "1", "", "abcd"
+	};
+
+	auto expected = strings;
+	std::stable_sort(
+		expected.begin(), expected.end(), 
+		[](const auto &lhs, const auto &rhs) 
+		{ 
+			return unicode::string_view(lhs) < unicode::string_view(rhs); 
+		}
+	);
+
+	auto sorted = strings;
+	unicode::stable_sort(sorted);
+	EXPECT_EQ(sorted, expected);
+
+	sorted = strings;
+	unicode::sort(sorted);
+	EXPECT_TRUE(
+		std::is_sorted(
+			sorted.begin(), sorted.end(), 
+			[](const auto &lhs, const auto &rhs)
+			{ 
+				return utf8::compare(lhs, rhs) < 0; 
+			}
+		)
+	);
+	EXPECT_TRUE(std::is_permutation(sorted.begin(), sorted.end(), strings.begin()));
+
+	std::vector<unicode::string_view> views(strings.begin(), strings.end());
+	unicode::stable_sort(views);
+	EXPECT_TRUE(
+		std::equal(
+			views.begin(), views.end(), expected.begin(),
+			[](const auto &view, const auto &str) 
+			{ 
+				return std::string_view(view) == str; 
+			}
+		)
+	);
+}
+
+TEST(algorithm, thread_pool)
+{
+	auto &pool = unicode::utility::thread_pool::shared(4);
+	EXPECT_EQ(&pool, &unicode::utility::thread_pool::shared(4));
+	EXPECT_EQ(pool.size(), 4);
+
+	// Exception is rethrown after all other tasks are finished
+	std::atomic<size_t> finished = 0;
+	std::vector<unicode::utility::thread_pool::task> tasks;
+	for (size_t i = 0; i < 64; ++i)
+	{
+		tasks.push_back(
+			[&finished, i]
+			{
+				if (i % 16 == 3) { throw std::runtime_error("task"); }
+				++finished;
+			}
+		);
+	}
+	EXPECT_THROW(pool.run(std::move(tasks)), std::runtime_error);
+	EXPECT_EQ(finished, 60);
+
+	// Pool stays usable, also by several threads at once
+	std::vector<std::jthread> callers;
+	for (size_t caller = 0; caller < 4; ++caller)
+	{
+		callers.emplace_back(
+			[&pool, &finished]
+			{
+				std::vector<unicode::utility::thread_pool::task> tasks(
+					16, [&finished] { ++finished; }
+				);
+				pool.run(std::move(tasks));
+			}
+		);
+	}
+	callers.clear();
+	EXPECT_EQ(finished, 124);
+}
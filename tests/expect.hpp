@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include "unicode/string_view.hpp"
+
+/// Expect that iteration in both directions matches indexing
+template<typename Layout>
+void expectIteration(const unicode::basic_string_view<Layout> &view)
+{
+	size_t index = 0;
+	for (auto it = view.begin(); it != view.end(); ++it, ++index)
+	{
+		ASSERT_EQ(std::string_view(*it), std::string_view(view[index])) 
+			<< "at " << index;
+	}
+	EXPECT_EQ(index, view.size());
+	for (auto it = view.end(); it != view.begin();)
+	{
+		--it;
+		--index;
+		ASSERT_EQ(std::string_view(*it), std::string_view(view[index])) 
+			<< "at " << index;
+	}
+}
@@ -0,0 +1,156 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <unicode/uchar.h>
+
+#include "../sources/icu.hpp"
+#include "../sources/grapheme.hpp"
+
+using namespace unicode;
+
+/// Get grapheme cluster boundaries, found by ICU
+static std::vector<size_t> boundariesICU(std::string_view text)
+{
+	std::vector<size_t> boundaries;
+	auto utext = openUText(text);
+	auto it = getCharacterBreakIterator(utext.get());
+	it->first();
+	for (auto end = it->next(); end != icu::BreakIterator::DONE; end = it->next())
+	{
+		boundaries.push_back(end);
+	}
+	return boundaries;
+}
+
+/// Get grapheme cluster boundaries, found by native segmenter
+static std::vector<size_t> boundaries(std::string_view text)
+{
+	std::vector<size_t> boundaries;
+	grapheme::segmenter segmenter(text);
+	for (auto end = segmenter.next(); end != segmenter.npos; end = segmenter.next())
+	{
+		boundaries.push_back(end);
+	}
+	return boundaries;
+}
+
+/// Encode code point as UTF-8
+static std::string toUTF8(UChar32 code_point)
+{
+	std::string result;
+	icu::UnicodeString(code_point).toUTF8String(result);
+	return result;
+}
+
+/// Get few code points for each combination of properties, known to ICU
+static std::vector<std::string> samples()
+{
+	constexpr size_t per_combination = 3;
+
+	std::map<std::pair<int32_t, bool>, size_t> found;
+	std::vector<std::string> samples;
+	for (UChar32 code_point = 0; code_point <= UCHAR_MAX_VALUE; ++code_point)
+	{
+		if (U_IS_SURROGATE(code_point)) { continue; }
+
+		auto key = std::pair{
+			u_getIntPropertyValue(code_point, UCHAR_GRAPHEME_CLUSTER_BREAK),
+			bool(u_hasBinaryProperty(code_point, UCHAR_EXTENDED_PICTOGRAPHIC))
+		};
+		if (found[key]++ < per_combination)
+		{
+			samples.push_back(toUTF8(code_point));
+		}
+	}
+	return samples;
+}
+
+TEST(segmenter, properties)
+{
+	for (UChar32 code_point = 0; code_point <= UCHAR_MAX_VALUE; ++code_point)
+	{
+		auto props = grapheme::properties_of(code_point);
+		EXPECT_EQ(
+			props.extended_pictographic(),
+			bool(u_hasBinaryProperty(code_point, UCHAR_EXTENDED_PICTOGRAPHIC))
+		) << code_point;
+		EXPECT_EQ(
+			props.category() == grapheme::category::extend,
+			u_getIntPropertyValue(code_point, UCHAR_GRAPHEME_CLUSTER_BREAK) ==
+				U_GCB_EXTEND
+		) << code_point;
+	}
+}
+
+TEST(segmenter, sequences)
+{
+	auto samples = ::samples();
+	for (auto &first : samples)
+	{
+		for (auto &second : samples)
+		{
+			auto pair = first + second;
+			ASSERT_EQ(boundaries(pair), boundariesICU(pair)) << pair;
+
+			for (auto &third : samples)
+			{
+				auto triple = pair + third;
+				ASSERT_EQ(boundaries(triple), boundariesICU(triple)) << triple;
+			}
+		}
+	}
+}
+
+TEST(segmenter, emoji)
+{
+	for (
+		std::string text : {
+			"👨‍👩‍👧‍👦👍🏽🇺🇸🇷🇺🇨",
+			"🇺🇸🇷🇺🇨🇳🇯🇵🇰🇷a🇰",
+			"a‍👍‍‍👍",
+			"👍́́‍👍́",
+			"😀‍́😀"
+		}
+	)
+	{
+		EXPECT_EQ(boundaries(text), boundariesICU(text)) << text;
+	}
+}
+
+TEST(segmenter, conjuncts)
+{
+	for (
+		std::string text : {
+			// Conjuncts of Devanagari, Bengali, Gujarati, Oriya, Telugu, Malayalam
+			"क्ष", "ক্ষ", "ક્ષ", "କ୍ଷ", "క్ష", "ക്ഷ",
+			// Chains of conjuncts, joiners and nukta between them
+			"स्त्री", "क्‍ष", "क़्ष", "क््ष", "कि्ष",
+			// ZWNJ and vowel signs stop conjuncts
+			"क्‌ष", "का्ष",
+			// Tamil virama doesn't link, neither do consonants of other scripts
+			"க்ஷ", "क्ক", "क्a",
+			// Virama without consonant before it
+			"्ष", "a्ष"
+		}
+	)
+	{
+		EXPECT_EQ(boundaries(text), boundariesICU(text)) << text;
+	}
+}
+
+TEST(segmenter, ill_formed)
+{
+	for (
+		std::string text : {
+			"\x80\x80", "a\xC0\x80", "\xE0\x80\x80", "\xE0\xA0", "\xED\xA0\x80",
+			"\xF0\x90\x80", "\xF4\x90\x80\x80", "\xFF\xFEx", "e\xCC", 
+			"\xE2\x80\x8D\xF0\x9F", "\xCC\x81\xCC"
+		}
+	)
+	{
+		EXPECT_EQ(boundaries(text), boundariesICU(text)) << text;
+	}
+}
@@ -0,0 +1,65 @@
+#include "unicode/grapheme_stream.hpp"
+#include "unicode/string_view.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace unicode;
+
+TEST(grapheme_stream, chunks)
+{
+	std::string text = 
+		"Привет, мир! 🇺🇸🇷🇺🇨 a👨‍👩‍👧 b你好，世界！\r\n\r\r\n"
+		"क्‍ष\xF0\x9F\xE2\x82 \xC0\x80 e\u0301\u0301 각 ";
+	for (int i = 0; i < 50; ++i) { text += "aб👍🏽e\u0301"; }
+
+	std::vector<std::string> expected;
+	for (auto character : unicode::string_view(text))
+	{
+		expected.emplace_back(character);
+	}
+
+	unicode::grapheme_stream stream;
+	std::mt19937 random(42);
+	for (size_t max_chunk : {1, 2, 3, 7, 64})
+	{
+		std::vector<std::string> characters;
+		auto collect = [&](unicode::character_view character)
+		{
+			characters.emplace_back(character);
+		};
+		std::uniform_int_distribution<size_t> chunk_size(0, max_chunk);
+		for (size_t offset = 0; offset < text.size();)
+		{
+			auto size = std::min(chunk_size(random), text.size() - offset);
+			stream.push(std::string_view(text).substr(offset, size), collect);
+			offset += size;
+			EXPECT_LE(stream.pending_size(), 64);
+		}
+		stream.finish(collect);
+		EXPECT_EQ(characters, expected) << "chunks up to " << max_chunk;
+	}
+
+	// Code point, cut by the end of text
+	for (std::string_view cut : {"\xE2\x82", "a\xE2\x82", "e\xCC"})
+	{
+		std::vector<std::string> characters;
+		auto collect = [&](unicode::character_view character)
+		{
+			characters.emplace_back(character);
+		};
+		stream.push(cut, collect);
+		stream.finish(collect);
+
+		std::vector<std::string> expected;
+		for (auto character : unicode::string_view(cut))
+		{
+			expected.emplace_back(character);
+		}
+		EXPECT_EQ(characters, expected) << cut;
+	}
+}
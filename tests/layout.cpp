@@ -0,0 +1,682 @@
+#include "unicode/string_view.hpp"
+#include "unicode/checkpoint_layout.hpp"
+#include "unicode/layout_builder.hpp"
+#include "unicode/lazy_layout.hpp"
+#include "unicode/string.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../sources/icu.hpp"
+#include "expect.hpp"
+
+using namespace unicode;
+
+/// Check that view splits string into same characters as ICU
+static void expectICUCharacters(const std::string &str)
+{
+	unicode::string_view view = str;
+
+	auto utext = openUText(str);
+	auto it = getCharacterBreakIterator(utext.get());
+	size_t index = 0;
+	for (
+		auto start = it->first(), end = it->next();
+		end != icu::BreakIterator::DONE;
+		start = end, end = it->next(), ++index
+	)
+	{
+		ASSERT_LT(index, view.size());
+		auto c = view[index];
+		auto substr = str.substr(start, end - start);
+		EXPECT_EQ(std::string_view(c), substr) << "at " << index;
+	}
+	EXPECT_EQ(view.size(), index);
+}
+
+TEST(layout, ascii)
+{
+	std::string ascii = "The quick brown fox jumps over the lazy dog. ";
+	expectICUCharacters(ascii);
+	expectICUCharacters(ascii + ascii + ascii);
+
+	auto layout = layout::of(ascii + ascii + ascii);
+	EXPECT_EQ(layout.block_count(), 1);
+
+	// CR LF is a single character
+	expectICUCharacters(ascii + "\r\n" + ascii + "\r" + ascii + "\n\r");
+	expectICUCharacters("\r\n\r\n\r\r\n\n");
+	expectICUCharacters(ascii + "\r\u0301" + ascii + "\r\n\u0301");
+
+	// Combining marks after ASCII
+	expectICUCharacters(ascii + "e\u0301" + ascii);
+	expectICUCharacters("e\u0301" + ascii + "a\u0308\u0301");
+	expectICUCharacters(ascii + "e\u200d\u0301" + ascii + "\u0301");
+
+	// Prepend character before ASCII
+	expectICUCharacters(ascii + "\u0600" + "1" + ascii);
+	expectICUCharacters("\u0600" + ascii);
+
+	// Short ASCII runs between non-ASCII text
+	expectICUCharacters("Привет, мир! 🇺🇸🇷🇺 a" + ascii + "б\n🇨🇳");
+	expectICUCharacters(ascii + "👨‍👩‍👧" + ascii + "\t" + "👍🏽");
+}
+
+TEST(layout, packed)
+{
+	utility::packed_vector values;
+	EXPECT_EQ(values.width(), 2);
+	values.push_back(1);
+	values.push_back(UINT16_MAX);
+	EXPECT_EQ(values.width(), 2);
+	values.push_back(UINT16_MAX + 1);
+	EXPECT_EQ(values.width(), 4);
+	values.set(0, UINT64_MAX);
+	EXPECT_EQ(values.width(), 8);
+	EXPECT_EQ(values[0], UINT64_MAX);
+	EXPECT_EQ(values[1], UINT16_MAX);
+	EXPECT_EQ(values[2], UINT16_MAX + 1);
+
+	// Characters, that don't fit into a byte, are stored separately
+	std::string big = "a";
+	for (int i = 0; i < 200; ++i) { big += "\u0301"; }
+	expectICUCharacters(big + big + "b" + big + "Привет" + big);
+
+	// Layout of mixed text is smaller than text itself
+	std::string str = "Привет, мир! 🇺🇸🇷🇺 你好，世界！";
+	for (int i = 0; i < 10; ++i) { str += str; }
+	unicode::string_view view = str;
+	auto layout = layout::of(str);
+	EXPECT_EQ(view.memory_usage(), layout.memory_usage());
+	EXPECT_LT(view.memory_usage(), str.size());
+}
+
+TEST(layout, narrow_columns)
+{
+	// Text of long runs, so layout has only offset and size columns,
+	// which take (offset width + byte offset width) * (blocks + 1) + blocks
+	std::string str = "Hello, world! Привет, мир! ";
+	for (int i = 0; i < 10; ++i) { str += str; }
+
+	// Offsets of small strings fit into 16 bits
+	ASSERT_LE(str.size(), UINT16_MAX);
+	auto small = layout_blocks::of(str);
+	EXPECT_GT(small.block_count(), 1);
+	EXPECT_LE(small.memory_usage(), (2 + 2 + 1) * (small.block_count() + 1));
+
+	// Only columns with bigger offsets are widened
+	str += str;
+	auto big = layout_blocks::of(str);
+	ASSERT_GT(str.size(), UINT16_MAX);
+	ASSERT_LE(big.characters(), UINT16_MAX);
+	EXPECT_LE(big.memory_usage(), (2 + 4 + 1) * (big.block_count() + 1));
+}
+
+TEST(layout, fragmented)
+{
+	// Alternating character sizes
+	std::string alternating;
+	for (int i = 0; i < 1000; ++i) { alternating += "aб"; }
+	expectICUCharacters(alternating);
+
+	unicode::string_view view = alternating;
+	EXPECT_LT(view.memory_usage(), 2 * view.size());
+	expectIteration(view);
+
+	// Emoji sequences, combining marks and characters of any size
+	std::string big = "a";
+	for (int i = 0; i < 200; ++i) { big += "\u0301"; }
+	std::string mixed;
+	for (int i = 0; i < 100; ++i)
+	{
+		mixed += "👨‍👩‍👧👍🏽🇺🇸e\u0301a1б你";
+		if (i % 10 == 0) { mixed += big; }
+	}
+	expectICUCharacters(mixed);
+
+	view = mixed;
+	EXPECT_LT(view.memory_usage(), 2 * view.size());
+	expectIteration(view);
+
+	// Fragmented text between long runs
+	auto text = "Hello, world! " + alternating + "Привет, мир! " + mixed;
+	expectICUCharacters(text);
+	expectIteration(unicode::string_view(text));
+}
+
+TEST(layout, btree_index)
+{
+	// Offsets with 1-4 levels and partial nodes
+	for (size_t size : {1, 2, 7, 8, 9, 63, 64, 65, 512, 513, 5000})
+	{
+		std::vector<size_t> offsets;
+		for (size_t i = 0; i < size; ++i) { offsets.push_back(i * 3); }
+
+		offset_index::binary_search binary;
+		offset_index::btree btree;
+		btree.build(offsets);
+		for (size_t value = 0; value < size * 3 + 5; ++value)
+		{
+			ASSERT_EQ(btree.find(offsets, value), binary.find(offsets, value))
+				<< "size " << size << ", value " << value;
+		}
+	}
+
+	// Same characters with any index
+	std::string str = "Привет, мир! 🇺🇸🇷🇺 a👨‍👩‍👧 b你好，世界！\r\n";
+	for (int i = 0; i < 5; ++i) { str += str; }
+
+	unicode::string_view view = str;
+	basic_string_view<basic_layout<offset_index::btree>> btree_view = str;
+	ASSERT_EQ(btree_view.size(), view.size());
+	for (size_t i = 0; i < view.size(); ++i)
+	{
+		EXPECT_EQ(std::string_view(btree_view[i]), std::string_view(view[i]));
+	}
+}
+
+TEST(layout, checkpoints)
+{
+	std::string str = "Привет, мир! 🇺🇸🇷🇺 a👨‍👩‍👧 b你好，世界！\r\n";
+	for (int i = 0; i < 5; ++i) { str += str; }
+	str += "a\u0301\u0302 end";
+
+	unicode::string_view view = str;
+	for (size_t interval : {1, 2, 3, 16, 64, 1000, 100000})
+	{
+		basic_string_view<checkpoint_layout> sparse(
+			str, checkpoint_layout::of(str, interval)
+		);
+		EXPECT_EQ(sparse.size(), view.size());
+		if (interval >= 16)
+		{
+			EXPECT_LE(sparse.memory_usage(), view.memory_usage());
+		}
+		for (size_t i = 0; i < view.size(); ++i)
+		{
+			ASSERT_EQ(std::string_view(sparse[i]), std::string_view(view[i]))
+				<< "interval " << interval << ", index " << i;
+		}
+		expectIteration(sparse);
+	}
+
+	// Interval is kept on update
+	basic_string_view<checkpoint_layout> sparse(
+		str, checkpoint_layout::of(str, 7)
+	);
+	sparse.update();
+	EXPECT_EQ(sparse.size(), view.size());
+
+	basic_string_view<checkpoint_layout> empty = "";
+	EXPECT_EQ(empty.size(), 0);
+	EXPECT_EQ(empty.begin(), empty.end());
+}
+
+TEST(layout, lazy)
+{
+	// Steps are cut inside of characters, CR LF and ASCII runs
+	std::string mixed = "Привет, мир! 🇺🇸🇷🇺 a👨‍👩‍👧 b你好，世界！\r\n";
+	for (int i = 0; i < 8; ++i) { mixed += mixed; }
+	std::string combining;
+	for (int i = 0; i < 5000; ++i) { combining += "e\u0301\r\n"; }
+	std::string ascii(100000, 'a');
+
+	for (auto &str : {mixed, combining, ascii})
+	{
+		// First character doesn't segment the whole string
+		auto layout = lazy_layout::of(str);
+		auto block = layout.block_index_for_character(0);
+		EXPECT_EQ(layout.run(block, 0).first, 0);
+		EXPECT_FALSE(layout.is_complete());
+		auto segmented = layout.segmented_characters();
+		EXPECT_LT(segmented, layout.characters());
+		EXPECT_TRUE(layout.is_complete());
+
+		unicode::string_view view = str;
+		basic_string_view<lazy_layout> lazy = str;
+		EXPECT_EQ(std::string_view(lazy.front()), std::string_view(view.front()));
+		for (size_t i = 0; i < view.size(); ++i)
+		{
+			ASSERT_EQ(std::string_view(lazy[i]), std::string_view(view[i]))
+				<< "index " << i;
+		}
+		EXPECT_EQ(lazy.size(), view.size());
+
+		// Iteration segments the string on the way
+		basic_string_view<lazy_layout> iterated = str;
+		expectIteration(iterated);
+	}
+
+	// Access to the first characters doesn't segment the whole string,
+	// even with assertions
+	basic_string_view<lazy_layout> first = ascii;
+	EXPECT_EQ(std::string_view(first[0]), "a");
+	EXPECT_EQ(std::string_view(first.front()), "a");
+	EXPECT_EQ(std::string_view(*first.begin()), "a");
+	EXPECT_EQ(std::string_view(first.begin()[1]), "a");
+	EXPECT_EQ(first.index_to_byte(1), 1);
+	EXPECT_FALSE(first.get_layout().is_complete());
+
+	basic_string_view<lazy_layout> empty = "";
+	EXPECT_EQ(empty.size(), 0);
+	EXPECT_EQ(empty.begin(), empty.end());
+
+	// Access segments the string, so it may throw
+	static_assert(!noexcept(empty.size()));
+	static_assert(!noexcept(empty[0]));
+	static_assert(!noexcept(++empty.begin()));
+	static_assert(!noexcept(std::declval<basic_string<lazy_layout> &>().size()));
+	static_assert(noexcept(std::declval<unicode::string_view &>().size()));
+	static_assert(noexcept(std::declval<unicode::string_view &>()[0]));
+	static_assert(noexcept(std::declval<unicode::string &>().size()));
+}
+
+/// Replace random ranges of text, updating layout, 
+/// and expect that layout matches the one of changed text
+template<typename Layout>
+static void expectUpdates(std::string text)
+{
+	const std::string insertions[] = {
+		"", "a", "\u0301", "🇺", "🇸", "\r", "\n", "\u200D", "👩", "你", 
+		"क्", "ष", "abc def", "е\u0301б"
+	};
+
+	// Offsets of code points
+	auto code_point_at = [&](size_t offset)
+	{
+		while (offset > 0 && (uint8_t(text[offset]) & 0xC0) == 0x80) 
+		{ 
+			--offset; 
+		}
+		return offset;
+	};
+
+	std::mt19937 random(42);
+	basic_string_view<Layout> view(text, Layout::of(text));
+	for (int i = 0; i < 200; ++i)
+	{
+		auto offset = code_point_at(random() % (text.size() + 1));
+		auto end = code_point_at(
+			std::min(text.size(), offset + random() % 8)
+		);
+		auto &insertion = insertions[random() % std::size(insertions)];
+		text.replace(offset, end - offset, insertion);
+		view.update(text, {offset, end - offset}, insertion.size());
+
+		unicode::string_view expected = text;
+		ASSERT_EQ(view.size(), expected.size()) << "edit " << i;
+		for (size_t j = 0; j < expected.size(); ++j)
+		{
+			ASSERT_EQ(
+				std::string_view(view[j]), std::string_view(expected[j])
+			) << "edit " << i << ", index " << j;
+		}
+	}
+	expectIteration(view);
+}
+
+TEST(layout, incremental_update)
+{
+	std::string mixed = "Привет, мир! 🇺🇸🇷🇺 a👨‍👩‍👧 b你好，世界！\r\n";
+	for (int i = 0; i < 3; ++i) { mixed += mixed; }
+	std::string fragmented;
+	for (int i = 0; i < 200; ++i) { fragmented += "aб👍🏽e\u0301"; }
+
+	for (auto &text : {mixed, fragmented, std::string("a"), std::string()})
+	{
+		expectUpdates<unicode::layout>(text);
+		expectUpdates<basic_layout<offset_index::btree>>(text);
+		expectUpdates<lazy_layout>(text);
+	}
+
+	// Lazy layout forgets runs, segmented after change
+	std::string text;
+	for (int i = 0; i < 16; ++i) { text += mixed; }
+	basic_string_view<lazy_layout> lazy = text;
+	lazy.front();
+	for (size_t offset : {size_t(5000), size_t(10)})
+	{
+		while ((uint8_t(text[offset]) & 0xC0) == 0x80) { --offset; }
+		text.insert(offset, "\u0301");
+		lazy.update(text, {offset, 0}, 2);
+
+		unicode::string_view expected = text;
+		ASSERT_EQ(lazy.size(), expected.size());
+		for (size_t i = 0; i < expected.size(); ++i)
+		{
+			ASSERT_EQ(std::string_view(lazy[i]), std::string_view(expected[i]));
+		}
+	}
+}
+
+TEST(layout, parallel)
+{
+	// Parts are split at ASCII, after line breaks or not at all
+	std::string mixed = "Привет, мир! 🇺🇸🇷🇺 a👨‍👩‍👧 b你好，世界！\r\n";
+	std::string chinese = "你好，世界！";
+	std::string lines = "е\u0301\r\n";
+	for (auto *text : {&mixed, &chinese, &lines})
+	{
+		while (text->size() < (2 << 20)) { *text += *text; }
+	}
+
+	for (auto &text : {mixed, chinese, lines})
+	{
+		auto serial = layout_blocks::of(text);
+		for (size_t threads : {1, 4})
+		{
+			EXPECT_TRUE(layout_blocks::parallel_of(text, threads) == serial)
+				<< "threads " << threads;
+		}
+	}
+	EXPECT_TRUE(layout_blocks::parallel_of("", 4) == layout_blocks::of(""));
+}
+
+/// Memory resource, that counts allocations
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+	/// Number of allocations
+	size_t allocations = 0;
+
+private:
+	void *do_allocate(size_t bytes, size_t alignment) override
+	{
+		++allocations;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void *p, size_t bytes, size_t alignment) override
+	{
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+
+	bool do_is_equal(const memory_resource &other) const noexcept override
+	{
+		return this == &other;
+	}
+};
+
+TEST(layout, memory_resource)
+{
+	std::string text = "Привет, мир! 🇺🇸🇷🇺 a👨‍👩‍👧 b你好，世界！\r\n";
+	for (int i = 0; i < 200; ++i) { text += "aб👍🏽e\u0301"; }
+	unicode::string_view expected = text;
+	auto data = layout::of(text).serialize(text);
+
+	// Nothing is allocated from default resource
+	counting_resource resource, fallback;
+	auto previous = std::pmr::set_default_resource(&fallback);
+	{
+		unicode::string_view view(text, &resource);
+		EXPECT_GT(resource.allocations, 0);
+		EXPECT_TRUE(std::equal(
+			view.begin(), view.end(), expected.begin(), expected.end()
+		));
+
+		auto blocks = layout::of(text, &resource);
+		EXPECT_EQ(blocks.resource(), &resource);
+		blocks.update(text, {0, 0}, 0);
+		EXPECT_EQ(blocks.resource(), &resource);
+		blocks.update(text);
+		EXPECT_EQ(blocks.resource(), &resource);
+
+		// Index is allocated from resource too
+		using btree_layout = basic_layout<offset_index::btree>;
+		auto indexed = btree_layout::of(text, &resource);
+		EXPECT_GT(indexed.memory_usage(), blocks.memory_usage());
+		btree_layout indexed_copy(indexed, &resource);
+		EXPECT_EQ(
+			indexed_copy.block_index_for_character(700), 
+			blocks.block_index_for_character(700)
+		);
+
+		// Resource, that runs out of memory, throws
+		std::array<std::byte, 256> buffer;
+		std::pmr::monotonic_buffer_resource bounded(
+			buffer.data(), buffer.size(), std::pmr::null_memory_resource()
+		);
+		EXPECT_THROW(layout::of(text, &bounded), std::bad_alloc);
+
+		auto loaded = layout::deserialize(data, text, &resource);
+		ASSERT_TRUE(loaded);
+		EXPECT_EQ(loaded->resource(), &resource);
+		EXPECT_TRUE(*loaded == blocks);
+
+		// Updates of views, their copies and slices keep resource
+		auto edited = text;
+		unicode::string_view updated(edited, &resource);
+		auto copy = updated;
+		auto slice = updated.substr(3, 100);
+		edited.replace(0, 2, "e\u0301");
+		updated.update(edited, {0, 2}, 3);
+		EXPECT_EQ(updated.get_layout().resource(), &resource);
+		updated.update();
+		EXPECT_EQ(updated.get_layout().resource(), &resource);
+		copy.update(edited, {0, 2}, 3);
+		EXPECT_EQ(copy.get_layout().resource(), &resource);
+		auto sliced = std::string(std::string_view(slice)) + "e\u0301";
+		slice.update(sliced, {sliced.size() - 3, 0}, 3);
+		EXPECT_EQ(slice.get_layout().resource(), &resource);
+		EXPECT_TRUE(std::equal(
+			updated.begin(), updated.end(), copy.begin(), copy.end()
+		));
+		EXPECT_EQ(fallback.allocations, 0);
+
+		// Inline layout keeps resource, when it outgrows inline storage
+		std::string grown = "alice";
+		unicode::string_view small(grown, &resource);
+		auto small_copy = small;
+		grown += text;
+		small_copy.update(grown, {5, 0}, text.size());
+		EXPECT_GT(small_copy.memory_usage(), 0);
+		EXPECT_EQ(small_copy.get_layout().resource(), &resource);
+		EXPECT_EQ(fallback.allocations, 0);
+
+		// Arena of views is freed at once
+		std::pmr::monotonic_buffer_resource arena(&resource);
+		for (size_t i = 0; i < 100; ++i)
+		{
+			unicode::string_view line(
+				std::string_view(text).substr(i, 50), 
+				&arena
+			);
+			EXPECT_EQ(line.get_layout().resource(), &arena);
+		}
+	}
+	std::pmr::set_default_resource(previous);
+	EXPECT_EQ(fallback.allocations, 0);
+}
+
+TEST(layout, inline_storage)
+{
+	// Short strings and ASCII strings of any length don't allocate
+	std::string ascii(100000, 'a');
+	std::vector<std::string_view> texts = {
+		"", "alice", "Привет, мир!", "bob 👍🏽", ascii
+	};
+	counting_resource resource;
+	auto previous = std::pmr::set_default_resource(&resource);
+	for (auto text : texts)
+	{
+		unicode::string_view view = text;
+		auto copy = view;
+		EXPECT_EQ(copy.memory_usage(), 0);
+		EXPECT_FALSE(copy.get_layout().is_shared());
+		expectIteration(copy);
+		auto slice = view.substr(view.size() / 2);
+		EXPECT_FALSE(slice.get_layout().is_shared());
+		expectIteration(slice);
+		expectIteration(view.substr(view.size() / 3, view.size() / 3));
+	}
+
+	// Inline layouts are updated in place, while they fit
+	std::string edited = "Привет, мир!";
+	unicode::string_view view(edited);
+	edited.replace(0, 2, "é");
+	view.update(edited, {0, 2}, 3);
+	EXPECT_FALSE(view.get_layout().is_shared());
+	expectIteration(view);
+	EXPECT_EQ(std::string_view(view[0]), "é");
+	std::pmr::set_default_resource(previous);
+	EXPECT_EQ(resource.allocations, 0);
+
+	// Inline layouts take the place of window, so views stay small
+	EXPECT_LE(sizeof(unicode::string_view), 11 * sizeof(void *));
+
+	// Layout is shared, when it outgrows inline storage
+	std::string text = "alice";
+	auto layout = shared_layout<unicode::layout>::of(text);
+	auto copy = layout;
+	text += " бa👍🏽";
+	for (int i = 0; i < 20; ++i) { text += "Привет, мир! бa"; }
+	layout.update(text, {5, 0}, text.size() - 5);
+	EXPECT_GT(layout.memory_usage(), 0);
+	EXPECT_EQ(copy.bytes(), 5);
+	unicode::string_view grown(text, layout);
+	expectIteration(grown);
+	EXPECT_EQ(std::string_view(grown[6]), "б");
+
+	// Inline vector moves to memory and back
+	utility::small_vector<uint8_t, 4> values;
+	std::array<uint8_t, 6> more = {1, 2, 3, 4, 5, 6};
+	values.assign(more.begin(), more.begin() + 2);
+	EXPECT_TRUE(values.is_inline());
+	values.insert(values.begin() + 1, more.begin(), more.end());
+	EXPECT_FALSE(values.is_inline());
+	EXPECT_EQ(values.size(), 8);
+	EXPECT_EQ(values[1], 1);
+	EXPECT_EQ(values[7], 2);
+	values.erase(values.begin(), values.begin() + 5);
+	values.shrink_to_fit();
+	EXPECT_TRUE(values.is_inline());
+	EXPECT_EQ(values.memory_usage(), 0);
+	EXPECT_EQ(values.back(), 2);
+}
+
+TEST(layout, builder)
+{
+	std::string text = "Привет, мир! 🇺🇸🇷🇺 a👨‍👩‍👧 b你好，世界！\r\n";
+	for (int i = 0; i < 100; ++i) { text += "aб👍🏽e\u0301 hello "; }
+	std::vector<std::string_view> rows;
+	for (size_t i = 0; i < 10000; ++i)
+	{
+		auto first = i * 7 % (text.size() - 100);
+		while ((uint8_t(text[first]) & 0xC0) == 0x80) { ++first; }
+		rows.push_back(std::string_view(text).substr(first, i % 100));
+	}
+
+	for (size_t threads : {1, 3})
+	{
+		layout_builder builder(threads);
+		EXPECT_EQ(builder.threads(), threads);
+		for (int batch = 0; batch < 2; ++batch)
+		{
+			auto layouts = builder.build(rows);
+			ASSERT_EQ(layouts.size(), rows.size());
+			for (size_t i = 0; i < rows.size(); ++i)
+			{
+				ASSERT_TRUE(layouts[i] == layout::of(rows[i])) << "at " << i;
+			}
+			layouts.clear();
+			builder.reset();
+		}
+	}
+}
+
+TEST(layout, serialization)
+{
+	std::string text = "Привет, мир! 🇺🇸🇷🇺 a👨‍👩‍👧 b你好，世界！\r\n";
+	for (int i = 0; i < 200; ++i) { text += "aб👍🏽e\u0301"; }
+	text += std::string(1000, 'a');
+
+	auto layout = layout_blocks::of(text);
+	auto data = layout.serialize(text);
+	auto loaded = layout_blocks::deserialize(data, text);
+	ASSERT_TRUE(loaded);
+	EXPECT_TRUE(*loaded == layout);
+
+	auto indexed = basic_layout<offset_index::btree>::deserialize(data, text);
+	ASSERT_TRUE(indexed);
+	basic_string_view<basic_layout<offset_index::btree>> view(text, *indexed);
+	unicode::string_view expected = text;
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		ASSERT_EQ(std::string_view(view[i]), std::string_view(expected[i]));
+	}
+
+	// Layout of empty string
+	auto empty = layout_blocks::deserialize(layout_blocks{}.serialize(""), "");
+	ASSERT_TRUE(empty);
+	EXPECT_TRUE(*empty == layout_blocks{});
+
+	// Stale or corrupted layouts are rejected
+	auto changed = text;
+	changed[0] = 'X';
+	EXPECT_FALSE(layout_blocks::deserialize(data, changed));
+	EXPECT_FALSE(layout_blocks::deserialize(data, text + "a"));
+	for (size_t i : {size_t(0), size_t(5), data.size() / 2, data.size() - 1})
+	{
+		auto corrupted = data;
+		corrupted[i] ^= std::byte(1);
+		EXPECT_FALSE(layout_blocks::deserialize(corrupted, text)) << "byte " << i;
+	}
+	for (size_t size : {size_t(0), size_t(10), data.size() - 1})
+	{
+		EXPECT_FALSE(
+			layout_blocks::deserialize(std::span(data).first(size), text)
+		) << "size " << size;
+	}
+
+	// Inconsistent columns are rejected, even if checksum matches them.
+	// Checksum is computed like in layout_format.cpp
+	auto reseal = [](std::vector<std::byte> data)
+	{
+		constexpr uint64_t multiplier = 0x9E3779B97F4A7C15;
+		auto bytes = std::span(data).first(data.size() - 8);
+		uint64_t hash = bytes.size() * multiplier;
+		for (size_t i = 0; i < bytes.size(); i += 8)
+		{
+			uint64_t word = 0;
+			for (size_t j = 0; j < 8 && i + j < bytes.size(); ++j)
+			{
+				word |= uint64_t(bytes[i + j]) << (8 * j);
+			}
+			hash = std::rotl((hash ^ word) * multiplier, 29);
+		}
+		if (bytes.size() % 8 == 0) 
+		{ 
+			hash = std::rotl(hash * multiplier, 29); 
+		}
+		hash ^= hash >> 32;
+		for (size_t j = 0; j < 8; ++j)
+		{
+			data[bytes.size() + j] = std::byte(hash >> (8 * j));
+		}
+		return data;
+	};
+	EXPECT_TRUE(layout_blocks::deserialize(reseal(data), text));
+
+	// Header is followed by offsets column of 16-bit width
+	constexpr size_t offsets = 4 + 4 + 8 + 8 + 8 + 8;
+	auto blocks = layout.block_count();
+	auto corrupt = [&](size_t index, uint16_t value)
+	{
+		auto corrupted = data;
+		corrupted[offsets + 2 * index] = std::byte(value);
+		corrupted[offsets + 2 * index + 1] = std::byte(value >> 8);
+		return layout_blocks::deserialize(reseal(corrupted), text);
+	};
+	EXPECT_FALSE(corrupt(1, 0)) << "empty block";
+	EXPECT_FALSE(corrupt(blocks / 2, 1)) << "offsets decrease";
+	EXPECT_FALSE(corrupt(blocks, UINT16_MAX)) << "characters after end";
+	EXPECT_FALSE(corrupt(blocks, layout.characters() - 1)) << "sizes mismatch";
+}
@@ -0,0 +1,110 @@
+#include "unicode/mapped_string_view.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+
+using namespace unicode;
+
+TEST(mapped_string_view, sidecar)
+{
+	std::string text = "Привет, мир! 🇺🇸🇷🇺 a👨‍👩‍👧 b你好，世界！\r\n";
+	for (int i = 0; i < 2000; ++i) { text += "aб👍🏽e\u0301"; }
+
+	auto path = 
+		std::filesystem::temp_directory_path() / "unicode_mapped_test.txt";
+	auto sidecar = unicode::mapped_string_view::sidecar_path(path);
+	auto write = [&](const std::filesystem::path &file, std::string_view data)
+	{
+		std::ofstream(file, std::ios::binary).write(data.data(), data.size());
+	};
+	auto expectCharacters = [](
+		const unicode::mapped_string_view &view, 
+		std::string_view text
+	)
+	{
+		unicode::string_view expected = text;
+		ASSERT_EQ(view.size(), expected.size());
+		EXPECT_EQ(std::string_view(view), text);
+		for (size_t i = 0; i < expected.size(); ++i)
+		{
+			ASSERT_EQ(std::string_view(view[i]), std::string_view(expected[i]));
+		}
+	};
+	write(path, text);
+	std::filesystem::remove(sidecar);
+
+	// Sidecar is built on the first mapping and reused later
+	{
+		unicode::mapped_string_view view(path);
+		EXPECT_FALSE(view.layout_loaded());
+		EXPECT_TRUE(std::filesystem::exists(sidecar));
+		// Sidecar is created like other files, with umask applied
+		EXPECT_EQ(
+			std::filesystem::status(sidecar).permissions(),
+			std::filesystem::status(path).permissions()
+		);
+		expectCharacters(view, text);
+	}
+	{
+		std::filesystem::remove(sidecar);
+		auto mask = ::umask(S_IRWXG | S_IRWXO);
+		unicode::mapped_string_view view(path);
+		::umask(mask);
+		EXPECT_EQ(
+			std::filesystem::status(sidecar).permissions(),
+			std::filesystem::perms::owner_read | 
+				std::filesystem::perms::owner_write
+		);
+	}
+	{
+		unicode::mapped_string_view view(path);
+		EXPECT_TRUE(view.layout_loaded());
+		expectCharacters(view, text);
+
+		auto moved = std::move(view);
+		expectCharacters(moved, text);
+	}
+
+	// Stale and corrupted sidecars are rebuilt
+	text.replace(0, 2, "e\u0301");
+	write(path, text);
+	{
+		unicode::mapped_string_view view(path);
+		EXPECT_FALSE(view.layout_loaded());
+		expectCharacters(view, text);
+	}
+	write(sidecar, "garbage");
+	{
+		unicode::mapped_string_view view(path);
+		EXPECT_FALSE(view.layout_loaded());
+		expectCharacters(view, text);
+	}
+
+	// Empty file
+	write(path, "");
+	{
+		unicode::mapped_string_view view(path);
+		EXPECT_TRUE(view.empty());
+	}
+
+	// Temporary files are renamed to sidecar
+	for (auto &entry : std::filesystem::directory_iterator(path.parent_path()))
+	{
+		auto name = entry.path().filename().string();
+		EXPECT_TRUE(
+			name == sidecar.filename() || 
+			!name.starts_with(sidecar.filename().string())
+		) << name;
+	}
+
+	std::filesystem::remove(path);
+	std::filesystem::remove(sidecar);
+	EXPECT_THROW(unicode::mapped_string_view{path}, std::system_error);
+}
@@ -0,0 +1,100 @@
+#include "unicode/segment_view.hpp"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../sources/icu.hpp"
+
+using namespace unicode;
+
+/// Expect that view splits string into same segments as ICU
+template<typename View>
+static void expectICUSegments(
+	const std::string &str, 
+	BreakIteratorFactory create
+)
+{
+	View view = str;
+
+	auto utext = openUText(str);
+	auto it = getBreakIterator(utext.get(), create);
+	std::vector<std::string_view> expected;
+	for (
+		auto start = it->first(), end = it->next();
+		end != icu::BreakIterator::DONE;
+		start = end, end = it->next()
+	)
+	{
+		expected.push_back(std::string_view(str).substr(start, end - start));
+	}
+
+	ASSERT_EQ(view.size(), expected.size());
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		EXPECT_EQ(std::string_view(view[i]), expected[i]) << "at " << i;
+	}
+	size_t index = 0;
+	for (auto segment : view)
+	{
+		EXPECT_EQ(std::string_view(segment), expected[index++]);
+	}
+}
+
+TEST(segment_view, icu)
+{
+	std::string text = 
+		"Hello, world! Привет, мир! 🇺🇸🇷🇺 你好，世界！\r\n"
+		"Mr. Smith paid $3.50 for a well-known e\u0301clair. ";
+	for (int i = 0; i < 300; ++i) 
+	{ 
+		text += i % 7 == 0 ? "Short. " : "aб👍🏽e\u0301 word, ";
+	}
+	text += std::string(1000, 'a') + " end.";
+
+	expectICUSegments<unicode::word_view>(
+		text, icu::BreakIterator::createWordInstance
+	);
+	expectICUSegments<unicode::sentence_view>(
+		text, icu::BreakIterator::createSentenceInstance
+	);
+	expectICUSegments<unicode::line_break_view>(
+		text, icu::BreakIterator::createLineInstance
+	);
+
+	unicode::word_view words = "Hello, world!";
+	EXPECT_EQ(words.size(), 5);
+	EXPECT_EQ(words[2], " ");
+	EXPECT_EQ(words[-2], "world");
+	EXPECT_TRUE(unicode::word_view("").empty());
+}
+
+TEST(segment_view, cached_break_iterator)
+{
+	// Cached iterator is moved to new text
+	LocalUText local;
+	auto create = icu::BreakIterator::createWordInstance;
+	auto it = getCachedBreakIterator(local.open("Hello, world!"), create);
+	ASSERT_NE(it, nullptr);
+	EXPECT_EQ(it->following(0), 5);
+	auto same = getCachedBreakIterator(local.open("Привет, мир!"), create);
+	EXPECT_EQ(same, it);
+	EXPECT_EQ(same->following(0), 12);
+
+	// Copies of prototype are independent
+	auto utext = openUText("a b");
+	auto copy = getBreakIterator(utext.get(), create);
+	ASSERT_NE(copy, nullptr);
+	EXPECT_NE(copy.get(), it);
+	EXPECT_EQ(copy->following(0), 1);
+	EXPECT_EQ(same->following(12), 13);
+
+	// Views over short strings reuse iterators
+	for (int i = 0; i < 100; ++i)
+	{
+		unicode::sentence_view sentences = "Short. Sentences.";
+		ASSERT_EQ(sentences.size(), 2);
+		EXPECT_EQ(sentences[1], "Sentences.");
+	}
+}
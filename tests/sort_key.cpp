@@ -0,0 +1,41 @@
+#include "unicode/utf8/compare.hpp"
+#include "unicode/utf8/comparator.hpp"
+#include "unicode/sort_key.hpp"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace unicode;
+
+TEST(sort_key, compare)
+{
+	std::vector<std::string_view> strings = {
+		"abcd", "a\u0301", "\u00e1", "1", "2", "в", "б", "", "A", "a"
+	};
+	for (auto lhs : strings)
+	{
+		for (auto rhs : strings)
+		{
+			EXPECT_EQ(
+				sort_key::of(lhs) <=> sort_key::of(rhs), 
+				utf8::compare(lhs, rhs)
+			) << lhs << " vs " << rhs;
+		}
+	}
+
+	utf8::comparator comparator("en_US", utf8::strength::primary);
+	EXPECT_EQ(comparator.key("a"), comparator.key("A"));
+	EXPECT_LT(comparator.key("a"), comparator.key("b"));
+
+	sort_keys keys(strings);
+	ASSERT_EQ(keys.size(), strings.size());
+	for (size_t i = 0; i < strings.size(); ++i)
+	{
+		EXPECT_EQ(
+			sort_key::compare(keys[i], sort_key::of(strings[i]).data()),
+			std::strong_ordering::equal
+		);
+	}
+}
@@ -0,0 +1,86 @@
+#include "unicode/string.hpp"
+#include "unicode/lazy_layout.hpp"
+
+#include <random>
+#include <string>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include "expect.hpp"
+
+using namespace unicode;
+
+TEST(string, mutation)
+{
+	unicode::string str;
+	EXPECT_TRUE(str.empty());
+	EXPECT_EQ(str.size(), 0);
+
+	// Characters are combined with appended text
+	str.append("Привет");
+	str.push_back("e");
+	str.push_back("\u0301");
+	str += "🇺";
+	str += "🇸\r";
+	str.push_back("\n");
+	EXPECT_EQ(str.str(), "Приветe\u0301🇺🇸\r\n");
+	EXPECT_EQ(str.size(), 9);
+	EXPECT_EQ(std::string_view(str[6]), "e\u0301");
+	EXPECT_EQ(std::string_view(str[7]), "🇺🇸");
+	EXPECT_EQ(std::string_view(str.back()), "\r\n");
+
+	// Indexes are in characters
+	str.insert(6, ", мир");
+	EXPECT_EQ(str.str(), "Привет, мирe\u0301🇺🇸\r\n");
+	str.erase(0, 8);
+	EXPECT_EQ(str.str(), "мирe\u0301🇺🇸\r\n");
+	str.replace(3, 2, "👨‍👩‍👧");
+	EXPECT_EQ(str.str(), "мир👨‍👩‍👧\r\n");
+	str.erase(4);
+	EXPECT_EQ(str.str(), "мир👨‍👩‍👧");
+	EXPECT_EQ(str.size(), 4);
+
+	// View refers to layout of string
+	auto view = str.view();
+	EXPECT_EQ(view.memory_usage(), 0);
+	EXPECT_EQ(view.size(), str.size());
+	expectIteration(view);
+
+	// View with own layout copies layout of string instead of segmenting
+	unicode::string_view copy(str);
+	EXPECT_EQ(std::string_view(copy), str.str());
+	EXPECT_EQ(copy.size(), view.size());
+	EXPECT_EQ(std::string_view(copy.back()), std::string_view(view.back()));
+	static_assert(
+		!std::is_constructible_v<
+			unicode::basic_string_view<unicode::lazy_layout>, 
+			const unicode::string &
+		>
+	);
+	unicode::string::view_type converted = str;
+	EXPECT_EQ(converted.memory_usage(), 0);
+
+	// Layout matches the one of the whole string after many changes
+	std::mt19937 random(42);
+	const std::string_view pieces[] = {
+		"a", "\u0301", "🇺", "б", "\r", "\n", "\u200D", "👩", "क्", "ष"
+	};
+	for (int i = 0; i < 1000; ++i)
+	{
+		auto &piece = pieces[random() % std::size(pieces)];
+		switch (random() % 4)
+		{
+			case 0: str.insert(random() % (str.size() + 1), piece); break;
+			case 1: str.erase(random() % (str.size() + 1), random() % 3); break;
+			default: str.append(piece); break;
+		}
+	}
+	unicode::string_view expected = str.str();
+	ASSERT_EQ(str.size(), expected.size());
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		ASSERT_EQ(std::string_view(str[i]), std::string_view(expected[i]));
+	}
+	expectIteration(str.view());
+}
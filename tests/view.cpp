@@ -1,7 +1,14 @@
 #include "unicode/utf8/compare.hpp"
+#include "unicode/utf8/comparator.hpp"
 #include "unicode/string_view.hpp"
+#include "unicode/checkpoint_layout.hpp"
+#include "unicode/string.hpp"
+#include "unicode/utility/sorted_vector.hpp"
 
+#include <algorithm>
+#include <random>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -39,6 +46,50 @@ TEST(UTF8, compare)
 	}
 }
 
+TEST(UTF8, comparator)
+{
+	{
+		utf8::comparator comparator;
+		EXPECT_EQ(
+			comparator.compare("a\u0301", "\u00e1"), 
+			std::strong_ordering::equal
+		);
+		EXPECT_TRUE(comparator("1", "2"));
+		EXPECT_FALSE(comparator("в", "б"));
+	}
+
+	{
+		utf8::comparator comparator("en_US", utf8::strength::primary);
+		EXPECT_EQ(comparator.compare("a", "A"), std::strong_ordering::equal);
+		EXPECT_EQ(comparator.compare("a", "á"), std::strong_ordering::equal);
+		EXPECT_EQ(comparator.compare("a", "b"), std::strong_ordering::less);
+	}
+
+	{
+		utf8::comparator comparator("en_US", utf8::strength::secondary);
+		EXPECT_EQ(comparator.compare("a", "A"), std::strong_ordering::equal);
+		EXPECT_EQ(comparator.compare("a", "á"), std::strong_ordering::less);
+	}
+
+	{
+		// Swedish sorts 'ö' after 'z', German doesn't
+		EXPECT_TRUE(utf8::comparator("sv_SE")("z", "ö"));
+		EXPECT_TRUE(utf8::comparator("de_DE")("ö", "z"));
+	}
+
+	{
+		std::vector<std::string_view> words = {"в", "б", "2", "a", "1"};
+		std::sort(words.begin(), words.end(), utf8::comparator());
+		std::vector<std::string_view> expected = {"1", "2", "a", "б", "в"};
+		EXPECT_EQ(words, expected);
+
+		utility::sorted_vector<std::string_view, utf8::comparator> sorted;
+		sorted.insert({"в", "б", "2", "a", "1"});
+		EXPECT_TRUE(std::equal(sorted.begin(), sorted.end(), expected.begin()));
+		EXPECT_TRUE(sorted.contains("б"));
+	}
+}
+
 TEST(string_view, compare)
 {
 	{
@@ -63,6 +114,361 @@ TEST(string_view, compare)
 	}
 }
 
+TEST(string_view, offset_translation)
+{
+	std::string text = "Hi\r\n";
+	for (int i = 0; i < 100; ++i) 
+	{ 
+		text += "aб👍🏽e\u0301 🇺🇸\xF0\x9F\xE2\x82 你好 ";
+	}
+
+	// Offsets of characters in bytes, code points and UTF-16 code units
+	unicode::string_view characters = text;
+	std::vector<size_t> bytes, code_points, utf16;
+	size_t code_point = 0, code_unit = 0;
+	for (size_t i = 0; i <= characters.size(); ++i)
+	{
+		auto byte = 
+			i == characters.size() ? 
+				text.size() : 
+				size_t(characters[i].data() - text.data());
+		bytes.push_back(byte);
+		code_points.push_back(code_point);
+		utf16.push_back(code_unit);
+		if (i == characters.size()) { break; }
+
+		auto c = std::string(characters[i]);
+		auto utext = openUText(c);
+		for (
+			auto cp = utext_next32(utext.get()); 
+			cp >= 0; 
+			cp = utext_next32(utext.get())
+		)
+		{
+			++code_point;
+			code_unit += cp > 0xFFFF ? 2 : 1;
+		}
+	}
+
+	unicode::translation_string_view view = text;
+	auto expectTranslations = [&](const auto &view)
+	{
+		for (size_t i = 0; i <= characters.size(); ++i)
+		{
+			ASSERT_EQ(view.index_to_byte(i), bytes[i]) << "at " << i;
+			ASSERT_EQ(view.index_to_code_point(i), code_points[i]) << "at " << i;
+			ASSERT_EQ(view.index_to_utf16(i), utf16[i]) << "at " << i;
+		}
+		// Offsets inside of characters map to characters, that contain them
+		for (size_t i = 0; i < characters.size(); ++i)
+		{
+			for (auto byte = bytes[i]; byte < bytes[i + 1]; ++byte)
+			{
+				ASSERT_EQ(view.byte_to_index(byte), i) << "byte " << byte;
+			}
+			for (auto cp = code_points[i]; cp < code_points[i + 1]; ++cp)
+			{
+				ASSERT_EQ(view.code_point_to_index(cp), i) 
+					<< "code point " << cp;
+			}
+			for (auto unit = utf16[i]; unit < utf16[i + 1]; ++unit)
+			{
+				ASSERT_EQ(view.utf16_to_index(unit), i) << "UTF-16 " << unit;
+			}
+		}
+		EXPECT_EQ(view.byte_to_index(text.size()), characters.size());
+		EXPECT_EQ(view.code_point_to_index(code_point), characters.size());
+		EXPECT_EQ(view.utf16_to_index(code_unit), characters.size());
+	};
+	expectTranslations(view);
+
+	// Columns follow changes of string
+	unicode::basic_string<unicode::translation_layout> str = text.substr(10);
+	str.insert(0, text.substr(0, 10));
+	expectTranslations(str.view());
+
+	// Slices translate offsets from their first character
+	for (size_t first = 0; first <= characters.size(); first += 37)
+	{
+		auto slice = view.substr(first, 150);
+		auto offset = [&](const std::vector<size_t> &offsets, size_t i)
+		{
+			return offsets[first + i] - offsets[first];
+		};
+		for (size_t i = 0; i <= slice.size(); ++i)
+		{
+			ASSERT_EQ(slice.index_to_code_point(i), offset(code_points, i));
+			ASSERT_EQ(slice.index_to_utf16(i), offset(utf16, i));
+		}
+		for (size_t i = 0; i <= slice.size(); ++i)
+		{
+			ASSERT_EQ(slice.code_point_to_index(offset(code_points, i)), i);
+			ASSERT_EQ(slice.utf16_to_index(offset(utf16, i)), i);
+			if (i != slice.size() && offset(utf16, i + 1) - offset(utf16, i) > 1)
+			{
+				ASSERT_EQ(slice.utf16_to_index(offset(utf16, i) + 1), i);
+			}
+		}
+	}
+	EXPECT_EQ(&view.substr(5).get_layout().get(), &view.get_layout().get());
+
+	// Columns are recounted after edits in the middle
+	auto expectSameTranslations = [](const auto &view)
+	{
+		unicode::translation_string_view expected = std::string_view(view);
+		ASSERT_EQ(view.size(), expected.size());
+		for (size_t i = 0; i <= view.size(); ++i)
+		{
+			ASSERT_EQ(view.index_to_code_point(i), expected.index_to_code_point(i));
+			ASSERT_EQ(view.index_to_utf16(i), expected.index_to_utf16(i));
+		}
+		auto units = expected.index_to_utf16(expected.size());
+		for (size_t unit = 0; unit <= units; unit += 7)
+		{
+			ASSERT_EQ(view.utf16_to_index(unit), expected.utf16_to_index(unit));
+		}
+	};
+	str.insert(str.size() / 2, "e\u0301👍🏽");
+	expectSameTranslations(str.view());
+	str.erase(str.size() / 3, 70);
+	expectSameTranslations(str.view());
+	str.replace(10, 200, "你好\u0301");
+	expectSameTranslations(str.view());
+	str.append("🇺🇸🇺");
+	str.insert(str.size() - 1, "🇺");
+	expectSameTranslations(str.view());
+	str.erase(0, 1);
+	expectSameTranslations(str.view());
+
+	// Random edits shift characters by any distance from checkpoints
+	std::mt19937 random(42);
+	std::vector<std::string> pieces = {
+		"a", "e\u0301", "\u0301", "👍🏽", "🇺", "\r", "\n", "你好", 
+		"\xF0\x9F", std::string(70, 'b'), std::string(130, 'c') + "б"
+	};
+	for (int i = 0; i < 300; ++i)
+	{
+		auto index = std::uniform_int_distribution<size_t>(0, str.size())(random);
+		auto count = std::uniform_int_distribution<size_t>(0, 80)(random);
+		auto piece = pieces[random() % pieces.size()];
+		str.replace(index, i % 3 == 0 ? 0 : count, i % 3 == 1 ? "" : piece);
+		expectSameTranslations(str.view());
+	}
+
+	// Code units of short strings with inline layouts are counted
+	for (
+		std::string_view text : 
+			{"abc", "Привет, мир!", "bob 👍🏽", "a\xF0\x9F 你好"}
+	)
+	{
+		unicode::translation_string_view view = text;
+		basic_string_view<translation_layout> expected = text;
+		EXPECT_FALSE(view.get_layout().is_shared());
+		for (size_t i = 0; i <= view.size(); ++i)
+		{
+			EXPECT_EQ(view.index_to_code_point(i), expected.index_to_code_point(i));
+			EXPECT_EQ(view.index_to_utf16(i), expected.index_to_utf16(i));
+		}
+		auto units = expected.index_to_utf16(view.size());
+		for (size_t unit = 0; unit <= units; ++unit)
+		{
+			EXPECT_EQ(view.utf16_to_index(unit), expected.utf16_to_index(unit));
+		}
+		auto first = expected.index_to_utf16(1);
+		for (size_t unit = first; unit <= units; ++unit)
+		{
+			EXPECT_EQ(
+				view.substr(1).utf16_to_index(unit - first), 
+				expected.utf16_to_index(unit) - 1
+			);
+		}
+	}
+
+	unicode::translation_string_view empty = "";
+	EXPECT_EQ(empty.index_to_utf16(0), 0);
+	EXPECT_EQ(empty.utf16_to_index(0), 0);
+}
+
+TEST(string_view, substr)
+{
+	std::string text = "Привет, мир! 🇺🇸🇷🇺 a👨‍👩‍👧 b你好，世界！\r\n";
+	for (int i = 0; i < 20; ++i) { text += "aб👍🏽e\u0301  "; }
+	text += std::string(100, 'a') + "e\u0301";
+
+	unicode::string_view view = text;
+	auto expectSlice = [&](
+		const unicode::string_view &slice, 
+		size_t first, 
+		size_t last
+	)
+	{
+		auto begin = view.index_to_byte(first);
+		auto end = view.index_to_byte(last);
+		EXPECT_EQ(
+			std::string_view(slice), 
+			std::string_view(text).substr(begin, end - begin)
+		);
+		ASSERT_EQ(slice.size(), last - first);
+		for (size_t i = 0; i < slice.size(); ++i)
+		{
+			ASSERT_EQ(slice[i], view[first + i]) << first << " " << i;
+		}
+		EXPECT_TRUE(std::equal(
+			slice.begin(), slice.end(), 
+			view.begin() + first, view.begin() + last
+		));
+		EXPECT_TRUE(std::equal(
+			slice.rbegin(), slice.rend(), 
+			std::make_reverse_iterator(view.begin() + last),
+			std::make_reverse_iterator(view.begin() + first)
+		));
+		for (size_t byte = 0; byte < std::string_view(slice).size(); ++byte)
+		{
+			ASSERT_EQ(
+				first + slice.byte_to_index(byte), 
+				view.byte_to_index(begin + byte)
+			);
+		}
+	};
+
+	for (size_t first = 0; first <= view.size(); first += 7)
+	{
+		for (size_t last = first; last <= view.size(); last += 13)
+		{
+			auto slice = view.substr(first, last - first);
+			expectSlice(slice, first, last);
+
+			// Slice of slice
+			if (slice.size() >= 2)
+			{
+				expectSlice(
+					slice.substr(1, slice.size() - 2), first + 1, last - 1
+				);
+			}
+		}
+	}
+	expectSlice(view.substr(5), 5, view.size());
+	expectSlice(
+		view.slice(view.begin() + 2, view.end() - 3), 2, view.size() - 3
+	);
+
+	// Copies and slices share layout
+	auto copy = view;
+	auto slice = view.substr(10, 20);
+	EXPECT_EQ(&copy.get_layout().get(), &view.get_layout().get());
+	EXPECT_EQ(&slice.get_layout().get(), &view.get_layout().get());
+}
+
+TEST(string_view, find)
+{
+	std::string text = "e\u0301 e caf\u00e9 cafe\u0301 👨‍👩‍👧 👨 👩 ";
+	for (int i = 0; i < 10; ++i) { text += "aб👍🏽e\u0301 e "; }
+	text += "\r\n\n👨";
+
+	unicode::string_view view = text;
+	std::string_view bytes = text;
+
+	// Indexes of matches, found by comparing bytes at each character
+	auto expected = [&](
+		const unicode::string_view &view, 
+		std::string_view needle
+	)
+	{
+		std::vector<size_t> indexes;
+		std::string_view string = view;
+		for (size_t i = 0; i <= view.size(); ++i)
+		{
+			auto first = view.index_to_byte(i);
+			if (string.substr(first).starts_with(needle))
+			{
+				auto end = first + needle.size();
+				if (view.index_to_byte(view.byte_to_index(end)) == end) 
+				{ 
+					indexes.push_back(i); 
+				}
+			}
+		}
+		return indexes;
+	};
+
+	for (std::string_view needle : {
+		"e", "e\u0301", "\u0301", "cafe", "👨", "👨‍👩‍👧", "\u200d", 
+		"👍", "👍🏽", "\n", "\r", "\r\n", " e ", "б", "x", "e \u0301"
+	})
+	{
+		auto all = expected(view, needle);
+		EXPECT_EQ(view.contains(needle), !all.empty()) << needle;
+		EXPECT_EQ(view.find(needle), all.empty() ? view.npos : all.front()) 
+			<< needle;
+		EXPECT_EQ(view.rfind(needle), all.empty() ? view.npos : all.back()) 
+			<< needle;
+		for (size_t i = 0; i <= view.size(); i += 3)
+		{
+			auto next = std::lower_bound(all.begin(), all.end(), i);
+			EXPECT_EQ(view.find(needle, i), next == all.end() ? view.npos : *next) 
+				<< needle << " " << i;
+			auto previous = std::upper_bound(all.begin(), all.end(), i);
+			EXPECT_EQ(
+				view.rfind(needle, i), 
+				previous == all.begin() ? view.npos : *(previous - 1)
+			) << needle << " " << i;
+		}
+
+		// Matches of find_all don't overlap
+		std::vector<size_t> separate;
+		for (auto index : all)
+		{
+			auto byte = view.index_to_byte(index);
+			if (
+				separate.empty() || 
+				byte >= view.index_to_byte(separate.back()) + needle.size()
+			)
+			{
+				separate.push_back(index);
+			}
+		}
+		EXPECT_EQ(view.find_all(needle), separate) << needle;
+
+		// Slices search only their characters
+		auto slice = view.substr(3, view.size() - 7);
+		EXPECT_EQ(slice.find_all(needle), expected(slice, needle)) << needle;
+	}
+
+	EXPECT_EQ(view.find("e"), 2u);
+	EXPECT_EQ(view.find("e\u0301"), 0u);
+	EXPECT_NE(bytes.find("cafe"), bytes.npos);
+	EXPECT_EQ(view.find("cafe"), view.npos);
+	EXPECT_FALSE(view.contains("👨‍👩"));
+	EXPECT_EQ(view.rfind("\n👨"), view.size() - 2);
+
+	// Pairs of regional indicators are flags, and the last one is alone
+	std::string indicators;
+	for (int i = 0; i < 5; ++i) { indicators += "🇺"; }
+	unicode::string_view flags = std::string_view(indicators).substr(0, 12);
+	EXPECT_EQ(flags.size(), 2u);
+	EXPECT_EQ(flags.find("🇺🇺"), 0u);
+	EXPECT_EQ(flags.rfind("🇺🇺"), 0u);
+	flags = indicators;
+	ASSERT_EQ(flags.size(), 3u);
+	EXPECT_EQ(flags.find_all("🇺🇺"), (std::vector<size_t>{0, 1}));
+	EXPECT_EQ(flags.rfind("🇺🇺"), 1u);
+	EXPECT_EQ(flags.rfind("🇺🇺", 0), 0u);
+	EXPECT_EQ(flags.rfind("🇺"), 2u);
+	EXPECT_EQ(flags.find("🇺"), 2u);
+
+	// Empty needle is found at each position
+	EXPECT_EQ(view.find(""), 0u);
+	EXPECT_EQ(view.find("", view.size()), view.size());
+	EXPECT_EQ(view.find("", view.size() + 1), view.npos);
+	EXPECT_EQ(view.rfind(""), view.size());
+	EXPECT_EQ(view.find_all("").size(), view.size() + 1);
+
+	unicode::string_view empty = "";
+	EXPECT_TRUE(empty.contains(""));
+	EXPECT_FALSE(empty.contains("a"));
+	EXPECT_EQ(empty.rfind("a"), empty.npos);
+}
+
 TEST(string_view, empty)
 {
 	unicode::string_view view = "";
@@ -180,4 +586,67 @@ TEST(string_view, reverse_iteration)
 		EXPECT_EQ(*it, view[index]);
 		--index;
 	}
-}
\ No newline at end of file
+}
+TEST(string_view, iterator_cursor)
+{
+	std::string str =
+		"🇺🇸: Hello, world!\n"
+		"🇷🇺: Привет, мир!\n"
+		"🇨🇳: 你好，世界！\n" 
+		"🇯🇵: こんにちは世界！\n" 
+		"🇰🇷: 안녕하세요 세계!\n"
+		"I💜Unicode";
+
+	unicode::string_view view = str;
+	auto size = std::ptrdiff_t(view.size());
+
+	// Walk forward and back across block boundaries
+	auto it = view.begin();
+	for (std::ptrdiff_t i = 0; i < size; ++i, ++it)
+	{
+		EXPECT_EQ(*it, view[i]);
+	}
+	EXPECT_EQ(it, view.end());
+	for (std::ptrdiff_t i = size - 1; i >= 0; --i)
+	{
+		--it;
+		EXPECT_EQ(*it, view[i]);
+	}
+	EXPECT_EQ(it, view.begin());
+
+	// Random jumps
+	for (std::ptrdiff_t step : {1, 3, 7, 20})
+	{
+		for (std::ptrdiff_t i = 0; i < size; i += step)
+		{
+			EXPECT_EQ(view.begin()[i], view[i]);
+			EXPECT_EQ(*(view.end() - (size - i)), view[i]);
+
+			auto jumped = view.begin() + i;
+			jumped += step / 2;
+			jumped -= step / 2;
+			EXPECT_EQ(*jumped, view[i]);
+		}
+	}
+
+	// End iterator starts at the run after the last block without search,
+	// so walking back from it crosses into the last block
+	auto walkBack = [](const auto &view)
+	{
+		auto it = view.end();
+		EXPECT_EQ(it - view.begin(), std::ptrdiff_t(view.size()));
+		for (auto i = view.size(); i-- > 0;)
+		{
+			--it;
+			EXPECT_EQ(std::string_view(*it), std::string_view(view[i]));
+		}
+		EXPECT_EQ(it, view.begin());
+	};
+	walkBack(view);
+	walkBack(view.substr(3, 20));
+	walkBack(unicode::string_view("aб👍🏽"));
+	walkBack(unicode::string_view());
+	walkBack(unicode::basic_string_view<unicode::checkpoint_layout>(str));
+	walkBack(unicode::basic_string_view<unicode::translation_layout>(str));
+	walkBack(unicode::string(str).view());
+}
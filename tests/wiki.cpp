@@ -1,11 +1,14 @@
 #include "unicode/string_view.hpp"
+#include "unicode/algorithm.hpp"
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
 #include <gtest/gtest.h>
 
 #include "../sources/icu.hpp"
+#include "../sources/grapheme.hpp"
 
 using namespace unicode;
 
@@ -40,10 +43,108 @@ static std::string readFile(const std::string &path)
 		} \
 	}
 
-TEST_LANGUAGE(english);
-TEST_LANGUAGE(russian);
-TEST_LANGUAGE(chinese);
-TEST_LANGUAGE(french);
-TEST_LANGUAGE(german);
-TEST_LANGUAGE(japanese);
-TEST_LANGUAGE(korean);
\ No newline at end of file
+/// Get grapheme cluster boundaries, found by ICU
+static std::vector<size_t> boundariesICU(std::string_view text)
+{
+	std::vector<size_t> boundaries;
+	auto utext = openUText(text);
+	auto it = getCharacterBreakIterator(utext.get());
+	it->first();
+	for (auto end = it->next(); end != icu::BreakIterator::DONE; end = it->next())
+	{
+		boundaries.push_back(end);
+	}
+	return boundaries;
+}
+
+/// Get grapheme cluster boundaries, found by native segmenter
+static std::vector<size_t> boundaries(std::string_view text)
+{
+	std::vector<size_t> boundaries;
+	grapheme::segmenter segmenter(text);
+	for (auto end = segmenter.next(); end != segmenter.npos; end = segmenter.next())
+	{
+		boundaries.push_back(end);
+	}
+	return boundaries;
+}
+
+#define TEST_SEGMENTER(language) \
+	TEST(segmenter, language) \
+	{ \
+		auto content = readFile("../../data/" #language "/wiki.txt"); \
+		EXPECT_EQ(boundaries(content), boundariesICU(content)); \
+	}
+
+#define TEST_CORPUS(language) \
+	TEST_LANGUAGE(language) \
+	TEST_SEGMENTER(language)
+
+TEST_CORPUS(english);
+TEST_CORPUS(russian);
+TEST_CORPUS(chinese);
+TEST_CORPUS(french);
+TEST_CORPUS(german);
+TEST_CORPUS(japanese);
+TEST_CORPUS(korean);
+
+/// Get some whitespace separated words of corpora
+static std::vector<std::string> readWords()
+{
+	std::vector<std::string> words;
+	for (auto language : {"english", "russian", "chinese", "german"})
+	{
+		std::istringstream stream(
+			readFile(std::string("../../data/") + language + "/wiki.txt")
+		);
+		for (std::string word; stream >> word && words.size() % 1000 != 999;)
+		{
+			words.push_back(word);
+		}
+		words.push_back(language);
+	}
+	return words;
+}
+
+TEST(wiki, sort)
+{
+	auto words = readWords();
+
+	auto expected = words;
+	std::stable_sort(
+		expected.begin(), expected.end(), 
+		[](const auto &lhs, const auto &rhs) 
+		{ 
+			return string_view(lhs) < string_view(rhs); 
+		}
+	);
+
+	unicode::stable_sort(words);
+	EXPECT_EQ(words, expected);
+}
+
+TEST(wiki, parallel_sort)
+{
+	// Repeat words with different suffixes to get many runs to merge
+	std::vector<std::string> words;
+	for (auto suffix : {"", "1", "a", "б", "\u00e1", "a\u0301", "字"})
+	{
+		for (auto &word : readWords()) { words.push_back(word + suffix); }
+	}
+
+	auto expected = words;
+	std::stable_sort(
+		expected.begin(), expected.end(), 
+		[](const auto &lhs, const auto &rhs) 
+		{ 
+			return utf8::compare(lhs, rhs) < 0; 
+		}
+	);
+
+	for (size_t threads : {1, 2, 3, 8})
+	{
+		auto sorted = words;
+		unicode::parallel_sort(sorted, threads);
+		EXPECT_EQ(sorted, expected) << threads << " threads";
+	}
+}
\ No newline at end of file